@@ -9,7 +9,10 @@
 #include "font_awesome_symbols.h"
 #include "iot/thing_manager.h"
 #include "assets/lang_config.h"
+#include "assets.h"
 #include "mcp_server.h"
+#include "telemetry.h"
+#include "heap_tag.h"
 
 #if CONFIG_USE_AUDIO_PROCESSOR
 #include "afe_audio_processor.h"
@@ -117,10 +120,16 @@ void Application::CheckNewVersion() {
         retry_delay = 10; // 重置重试延迟时间
 
         if (ota_.HasNewVersion()) {
+#if CONFIG_USE_BACKGROUND_OTA
+            // 新固件在后台下载，设备继续正常启动
+            StartBackgroundUpgrade();
+#else
             Alert(Lang::Strings::OTA_UPGRADE, Lang::Strings::UPGRADING, "happy", Lang::Sounds::P3_UPGRADE);
 
             vTaskDelay(pdMS_TO_TICKS(3000));
 
+            // 升级前要停止音频处理和唤醒词检测，必须等它们初始化完成
+            xEventGroupWaitBits(event_group_, BOOT_INIT_DONE_EVENT, pdFALSE, pdFALSE, portMAX_DELAY);
             SetDeviceState(kDeviceStateUpgrading);
             
             display->SetIcon(FONT_AWESOME_DOWNLOAD);
@@ -157,9 +166,10 @@ void Application::CheckNewVersion() {
             vTaskDelay(pdMS_TO_TICKS(3000));
             Reboot();
             return;
+#endif
         }
 
-        // No new version, mark the current version as valid
+        // No new version or it is downloading in background, mark the current version as valid
         ota_.MarkCurrentVersionValid();
         if (!ota_.HasActivationCode() && !ota_.HasActivationChallenge()) {
             xEventGroupSetBits(event_group_, CHECK_NEW_VERSION_DONE_EVENT);
@@ -192,13 +202,30 @@ void Application::CheckNewVersion() {
     }
 }
 
+void Application::StartBackgroundUpgrade() {
+    if (ota_task_handle_ != nullptr) {
+        return;
+    }
+    // 之后的版本检查会更新 ota_ 中的地址，下载任务只使用这里的副本
+    ota_target_ = ota_.GetUpgradeTarget();
+    ESP_LOGI(TAG, "Downloading new version %s in background", ota_target_.version.c_str());
+    // 优先级低于音频和主循环，只在设备空闲时占用 CPU
+    xTaskCreate([](void* arg) {
+        Application* app = (Application*)arg;
+        app->ota_.DownloadUpgrade(app->ota_target_, nullptr);
+        // 下载失败后，下一次版本检查可以重新开始下载
+        app->ota_task_handle_ = nullptr;
+        vTaskDelete(NULL);
+    }, "ota_download", 4096 * 2, this, 1, &ota_task_handle_);
+}
+
 void Application::ShowActivationCode() {
     auto& message = ota_.GetActivationMessage();
     auto& code = ota_.GetActivationCode();
 
     struct digit_sound {
         char digit;
-        const std::string_view& sound;
+        std::string_view sound;
     };
     static const std::array<digit_sound, 10> digit_sounds{{
         digit_sound{'0', Lang::Sounds::P3_0},
@@ -272,6 +299,7 @@ void Application::PlaySound(const std::string_view& sound) {
 
         std::lock_guard<std::mutex> lock(mutex_);
         audio_decode_queue_.emplace_back(std::move(packet));
+        decode_packets_queued_++;
     }
 }
 
@@ -356,16 +384,31 @@ void Application::StopListening() {
 }
 
 void Application::Start() {
+    // 板级初始化（包括显示屏）在进入 Start 之前完成
+    RecordBootPhase("board", 0);
     auto& board = Board::GetInstance();
     SetDeviceState(kDeviceStateStarting);
 
+#if CONFIG_USE_ASSETS_PARTITION
+    /* Map the assets partition before any sound is played, errors are logged once by Assets */
+    Assets::GetInstance();
+#endif
+
+#if CONFIG_USE_TELEMETRY
+    Telemetry::GetInstance().Start();
+#endif
+
     /* Setup the display */
     auto display = board.GetDisplay();
 
     /* Setup the audio codec */
+    auto phase_start = esp_timer_get_time();
     auto codec = board.GetAudioCodec();
-    opus_decoder_ = std::make_unique<OpusDecoderWrapper>(codec->output_sample_rate(), 1, OPUS_FRAME_DURATION_MS);
-    opus_encoder_ = std::make_unique<OpusEncoderWrapper>(16000, 1, OPUS_FRAME_DURATION_MS);
+    {
+        HeapTagScope heap_tag_scope(kHeapTagOpus);
+        opus_decoder_ = std::make_unique<OpusDecoderWrapper>(codec->output_sample_rate(), 1, OPUS_FRAME_DURATION_MS);
+        opus_encoder_ = std::make_unique<OpusEncoderWrapper>(16000, 1, OPUS_FRAME_DURATION_MS);
+    }
     if (aec_mode_ != kAecOff) {
         ESP_LOGI(TAG, "AEC mode: %d, setting opus encoder complexity to 0", aec_mode_);
         opus_encoder_->SetComplexity(0);
@@ -382,6 +425,14 @@ void Application::Start() {
         reference_resampler_.Configure(codec->input_sample_rate(), 16000);
     }
     codec->Start();
+    RecordBootPhase("codec", phase_start);
+
+    // 音频处理和唤醒词模型的加载与网络连接、版本检查同时进行
+    xTaskCreate([](void* arg) {
+        Application* app = (Application*)arg;
+        app->InitializeInBackground(Board::GetInstance().GetAudioCodec());
+        vTaskDelete(NULL);
+    }, "boot_init", 4096 * 2, this, 2, nullptr);
 
 #if CONFIG_USE_AUDIO_PROCESSOR
     xTaskCreatePinnedToCore([](void* arg) {
@@ -401,29 +452,31 @@ void Application::Start() {
     esp_timer_start_periodic(clock_timer_handle_, 1000000);
 
     /* Wait for the network to be ready */
+    phase_start = esp_timer_get_time();
     board.StartNetwork();
+    RecordBootPhase("network", phase_start);
 
     // Update the status bar immediately to show the network state
     display->UpdateStatusBar(true);
 
     // Check for new firmware version or get the MQTT broker address
+    phase_start = esp_timer_get_time();
     CheckNewVersion();
+    RecordBootPhase("version_check", phase_start);
 
     // Initialize the protocol
     display->SetStatus(Lang::Strings::LOADING_PROTOCOL);
 
-    // Add MCP common tools before initializing the protocol
-#if CONFIG_IOT_PROTOCOL_MCP
-    McpServer::GetInstance().AddCommonTools();
-#endif
-
-    if (ota_.HasMqttConfig()) {
-        protocol_ = std::make_unique<MqttProtocol>();
-    } else if (ota_.HasWebsocketConfig()) {
-        protocol_ = std::make_unique<WebsocketProtocol>();
-    } else {
-        ESP_LOGW(TAG, "No protocol specified in the OTA config, using MQTT");
-        protocol_ = std::make_unique<MqttProtocol>();
+    {
+        HeapTagScope heap_tag_scope(kHeapTagProtocol);
+        if (ota_.HasMqttConfig()) {
+            protocol_ = std::make_unique<MqttProtocol>();
+        } else if (ota_.HasWebsocketConfig()) {
+            protocol_ = std::make_unique<WebsocketProtocol>();
+        } else {
+            ESP_LOGW(TAG, "No protocol specified in the OTA config, using MQTT");
+            protocol_ = std::make_unique<MqttProtocol>();
+        }
     }
 
     protocol_->OnNetworkError([this](const std::string& message) {
@@ -434,15 +487,21 @@ void Application::Start() {
         std::lock_guard<std::mutex> lock(mutex_);
         if (audio_decode_queue_.size() < MAX_AUDIO_PACKETS_IN_QUEUE) {
             audio_decode_queue_.emplace_back(std::move(packet));
+            decode_packets_queued_++;
         }
     });
     protocol_->OnAudioChannelOpened([this, codec, &board]() {
         board.SetPowerSaveMode(false);
+        ota_.PauseUpgrade(true);
         if (protocol_->server_sample_rate() != codec->output_sample_rate()) {
             ESP_LOGW(TAG, "Server sample rate %d does not match device output sample rate %d, resampling may cause distortion",
                 protocol_->server_sample_rate(), codec->output_sample_rate());
         }
         SetDecodeSampleRate(protocol_->server_sample_rate(), protocol_->server_frame_duration());
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            image_channel_opened_ = protocol_->SupportsImage();
+        }
 
 #if CONFIG_IOT_PROTOCOL_XIAOZHI
         auto& thing_manager = iot::ThingManager::GetInstance();
@@ -455,6 +514,18 @@ void Application::Start() {
     });
     protocol_->OnAudioChannelClosed([this, &board]() {
         board.SetPowerSaveMode(true);
+        ota_.PauseUpgrade(false);
+#if CONFIG_IOT_PROTOCOL_MCP
+        McpServer::GetInstance().CloseSession();
+#endif
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            image_channel_opened_ = false;
+            image_send_queue_.clear();
+            image_results_.clear();
+        }
+        image_send_cv_.notify_all();
+        image_result_cv_.notify_all();
         Schedule([this]() {
             auto display = Board::GetInstance().GetDisplay();
             display->SetChatMessage("system", "");
@@ -476,6 +547,8 @@ void Application::Start() {
             } else if (strcmp(state->valuestring, "stop") == 0) {
                 Schedule([this]() {
                     background_task_->WaitForCompletion();
+                    // 显示还没来得及显示的句子
+                    RevealSentences(true);
                     if (device_state_ == kDeviceStateSpeaking) {
                         if (listening_mode_ == kListeningModeManualStop) {
                             SetDeviceState(kDeviceStateIdle);
@@ -488,9 +561,9 @@ void Application::Start() {
                 auto text = cJSON_GetObjectItem(root, "text");
                 if (cJSON_IsString(text)) {
                     ESP_LOGI(TAG, "<< %s", text->valuestring);
-                    Schedule([this, display, message = std::string(text->valuestring)]() {
-                        display->SetChatMessage("assistant", message.c_str());
-                    });
+                    // 文本先于对应的音频到达，等播放到该句的第一包音频时再显示
+                    std::lock_guard<std::mutex> lock(sentence_mutex_);
+                    pending_sentences_.push_back({decode_packets_queued_.load(), text->valuestring});
                 }
             }
         } else if (strcmp(type->valuestring, "stt") == 0) {
@@ -511,7 +584,8 @@ void Application::Start() {
 #if CONFIG_IOT_PROTOCOL_MCP
         } else if (strcmp(type->valuestring, "mcp") == 0) {
             auto payload = cJSON_GetObjectItem(root, "payload");
-            if (cJSON_IsObject(payload)) {
+            // A batch of JSON-RPC requests is sent as an array
+            if (cJSON_IsObject(payload) || cJSON_IsArray(payload)) {
                 McpServer::GetInstance().ParseMessage(payload);
             }
 #endif
@@ -539,6 +613,19 @@ void Application::Start() {
                     ESP_LOGW(TAG, "Unknown system command: %s", command->valuestring);
                 }
             }
+        } else if (strcmp(type->valuestring, "image") == 0) {
+            // The result of an image uploaded over the audio channel
+            auto id = cJSON_GetObjectItem(root, "id");
+            auto payload = cJSON_GetObjectItem(root, "payload");
+            if (cJSON_IsNumber(id) && cJSON_IsObject(payload)) {
+                auto json_str = cJSON_PrintUnformatted(payload);
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    image_results_[id->valueint] = json_str;
+                }
+                cJSON_free(json_str);
+                image_result_cv_.notify_all();
+            }
         } else if (strcmp(type->valuestring, "alert") == 0) {
             auto status = cJSON_GetObjectItem(root, "status");
             auto message = cJSON_GetObjectItem(root, "message");
@@ -552,9 +639,21 @@ void Application::Start() {
             ESP_LOGW(TAG, "Unknown message type: %s", type->valuestring);
         }
     });
-    bool protocol_started = protocol_->Start();
 
-    audio_processor_->Initialize(codec);
+    // MCP 工具必须在协议启动前注册完成
+    phase_start = esp_timer_get_time();
+    // 不清除该位，版本检查任务在进入升级状态前也要等待它
+    xEventGroupWaitBits(event_group_, BOOT_INIT_DONE_EVENT, pdFALSE, pdFALSE, portMAX_DELAY);
+    RecordBootPhase("wait_init", phase_start);
+
+    phase_start = esp_timer_get_time();
+    bool protocol_started;
+    {
+        HeapTagScope heap_tag_scope(kHeapTagProtocol);
+        protocol_started = protocol_->Start();
+    }
+    RecordBootPhase("protocol", phase_start);
+
     audio_processor_->OnOutput([this](std::vector<int16_t>&& data) {
         background_task_->Schedule([this, data = std::move(data)]() mutable {
             opus_encoder_->Encode(std::move(data), [this](std::vector<uint8_t>&& opus) {
@@ -601,7 +700,6 @@ void Application::Start() {
     });
 
 #if CONFIG_USE_WAKE_WORD_DETECT
-    wake_word_detect_.Initialize(codec);
     wake_word_detect_.OnWakeWordDetected([this](const std::string& wake_word) {
         Schedule([this, &wake_word]() {
             if (device_state_ == kDeviceStateIdle) {
@@ -635,6 +733,8 @@ void Application::Start() {
     // Wait for the new version check to finish
     xEventGroupWaitBits(event_group_, CHECK_NEW_VERSION_DONE_EVENT, pdTRUE, pdFALSE, portMAX_DELAY);
     SetDeviceState(kDeviceStateIdle);
+    RecordBootPhase("ready", 0);
+    PrintBootTimeline();
 
     if (protocol_started) {
         std::string message = std::string(Lang::Strings::VERSION) + ota_.GetCurrentVersion();
@@ -652,6 +752,57 @@ void Application::Start() {
     MainEventLoop();
 }
 
+void Application::InitializeInBackground(AudioCodec* codec) {
+    auto phase_start = esp_timer_get_time();
+    {
+        HeapTagScope heap_tag_scope(kHeapTagAfe);
+        audio_processor_->Initialize(codec);
+#if CONFIG_USE_WAKE_WORD_DETECT
+        wake_word_detect_.Initialize(codec);
+#endif
+    }
+    RecordBootPhase("models", phase_start);
+
+#if CONFIG_IOT_PROTOCOL_MCP
+    phase_start = esp_timer_get_time();
+    McpServer::GetInstance().AddCommonTools();
+    RecordBootPhase("mcp_tools", phase_start);
+#endif
+    xEventGroupSetBits(event_group_, BOOT_INIT_DONE_EVENT);
+}
+
+void Application::RecordBootPhase(const char* name, int64_t start_us) {
+    std::lock_guard<std::mutex> lock(boot_mutex_);
+    if (boot_phases_.size() < MAX_BOOT_PHASES) {
+        boot_phases_.push_back({name, start_us, esp_timer_get_time()});
+    }
+}
+
+void Application::PrintBootTimeline() {
+    std::lock_guard<std::mutex> lock(boot_mutex_);
+    for (auto& phase : boot_phases_) {
+        ESP_LOGI(TAG, "Boot phase %-14s %6d ms -> %6d ms (%d ms)", phase.name, (int)(phase.start_us / 1000),
+            (int)(phase.end_us / 1000), (int)((phase.end_us - phase.start_us) / 1000));
+    }
+}
+
+std::string Application::GetBootTimelineJson() {
+    std::lock_guard<std::mutex> lock(boot_mutex_);
+    cJSON* root = cJSON_CreateArray();
+    for (auto& phase : boot_phases_) {
+        cJSON* item = cJSON_CreateObject();
+        cJSON_AddStringToObject(item, "name", phase.name);
+        cJSON_AddNumberToObject(item, "start_ms", phase.start_us / 1000);
+        cJSON_AddNumberToObject(item, "duration_ms", (phase.end_us - phase.start_us) / 1000);
+        cJSON_AddItemToArray(root, item);
+    }
+    auto json_str = cJSON_PrintUnformatted(root);
+    std::string json(json_str);
+    cJSON_free(json_str);
+    cJSON_Delete(root);
+    return json;
+}
+
 void Application::OnClockTimer() {
     clock_ticks_++;
 
@@ -662,7 +813,24 @@ void Application::OnClockTimer() {
     if (clock_ticks_ % 10 == 0) {
         // SystemInfo::PrintTaskCpuUsage(pdMS_TO_TICKS(1000));
         // SystemInfo::PrintTaskList();
+#if !CONFIG_USE_TELEMETRY
         SystemInfo::PrintHeapStats();
+#endif
+        SystemInfo::PrintHeapTagStats();
+
+        int stall_count = main_loop_stall_count_.exchange(0);
+        int stall_ms = main_loop_stall_us_.exchange(0) / 1000;
+        int max_task_ms = main_loop_max_task_us_.exchange(0) / 1000;
+        if (stall_count > 0) {
+            ESP_LOGW(TAG, "Main loop: %d stalls, %d ms stalled, longest task %d ms", stall_count, stall_ms, max_task_ms);
+        }
+
+        auto ui_stats = display->GetUiQueueStats();
+        if (ui_stats.applied > 0) {
+            ESP_LOGI(TAG, "UI queue: %d applied, %d coalesced, depth %d (max %d), latency avg %d ms max %d ms",
+                ui_stats.applied, ui_stats.coalesced, ui_stats.depth, ui_stats.max_depth,
+                (int)(ui_stats.total_latency_us / ui_stats.applied / 1000), (int)(ui_stats.max_latency_us / 1000));
+        }
 
         // If we have synchronized server time, set the status to clock "HH:MM" if the device is idle
         if (ota_.HasServerTime()) {
@@ -677,6 +845,18 @@ void Application::OnClockTimer() {
             }
         }
     }
+
+#if CONFIG_USE_BACKGROUND_OTA
+    // 后台下载的新固件在设备持续空闲一段时间后生效，clock_ticks_ 在状态切换时清零
+    if (ota_.IsUpgradePending() && device_state_ == kDeviceStateIdle && clock_ticks_ >= CONFIG_OTA_ACTIVATE_IDLE_SECONDS) {
+        Schedule([this]() {
+            if (device_state_ == kDeviceStateIdle) {
+                ESP_LOGI(TAG, "Rebooting to activate the new firmware");
+                Reboot();
+            }
+        });
+    }
+#endif
 }
 
 // Add a async task to MainLoop
@@ -693,7 +873,7 @@ void Application::Schedule(std::function<void()> callback) {
 // they should use Schedule to call this function
 void Application::MainEventLoop() {
     while (true) {
-        auto bits = xEventGroupWaitBits(event_group_, SCHEDULE_EVENT | SEND_AUDIO_EVENT, pdTRUE, pdFALSE, portMAX_DELAY);
+        auto bits = xEventGroupWaitBits(event_group_, SCHEDULE_EVENT | SEND_AUDIO_EVENT | SEND_IMAGE_EVENT, pdTRUE, pdFALSE, portMAX_DELAY);
 
         if (bits & SEND_AUDIO_EVENT) {
             std::unique_lock<std::mutex> lock(mutex_);
@@ -706,12 +886,50 @@ void Application::MainEventLoop() {
             }
         }
 
+        // Only a few image packets are sent each round, so that the audio packets are not delayed
+        if (bits & SEND_IMAGE_EVENT) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            std::list<ImageStreamPacket> packets;
+            for (int i = 0; i < MAX_IMAGE_PACKETS_PER_ROUND && !image_send_queue_.empty(); i++) {
+                packets.splice(packets.end(), image_send_queue_, image_send_queue_.begin());
+            }
+            bool has_more = !image_send_queue_.empty();
+            lock.unlock();
+            image_send_cv_.notify_all();
+            for (auto& packet : packets) {
+                if (!protocol_->SendImage(packet)) {
+                    // 通道已断开，让等待中的摄像头线程尽快退出
+                    lock.lock();
+                    image_channel_opened_ = false;
+                    image_send_queue_.clear();
+                    has_more = false;
+                    lock.unlock();
+                    image_send_cv_.notify_all();
+                    image_result_cv_.notify_all();
+                    break;
+                }
+            }
+            if (has_more) {
+                xEventGroupSetBits(event_group_, SEND_IMAGE_EVENT);
+            }
+        }
+
         if (bits & SCHEDULE_EVENT) {
             std::unique_lock<std::mutex> lock(mutex_);
             auto tasks = std::move(main_tasks_);
             lock.unlock();
             for (auto& task : tasks) {
+                auto start_time = esp_timer_get_time();
                 task();
+                uint32_t elapsed_us = esp_timer_get_time() - start_time;
+                if (elapsed_us > main_loop_max_task_us_) {
+                    main_loop_max_task_us_ = elapsed_us;
+                }
+                if (elapsed_us >= MAIN_LOOP_STALL_THRESHOLD_MS * 1000) {
+                    main_loop_stall_count_++;
+                    main_loop_stall_us_ += elapsed_us;
+                    ESP_LOGW(TAG, "Main loop stalled for %d ms by a scheduled task", (int)(elapsed_us / 1000));
+                }
             }
         }
     }
@@ -750,8 +968,11 @@ void Application::OnAudioOutput() {
     }
 
     if (device_state_ == kDeviceStateListening) {
+        int dropped = audio_decode_queue_.size();
         audio_decode_queue_.clear();
+        lock.unlock();
         audio_decode_cv_.notify_all();
+        OnAudioPacketsConsumed(dropped, false);
         return;
     }
 
@@ -764,11 +985,13 @@ void Application::OnAudioOutput() {
     background_task_->Schedule([this, codec, packet = std::move(packet)]() mutable {
         busy_decoding_audio_ = false;
         if (aborted_) {
+            OnAudioPacketsConsumed(1, false);
             return;
         }
 
         std::vector<int16_t> pcm;
         if (!opus_decoder_->Decode(std::move(packet.payload), pcm)) {
+            OnAudioPacketsConsumed(1, true);
             return;
         }
         // Resample if the sample rate is different
@@ -785,9 +1008,78 @@ void Application::OnAudioOutput() {
             last_output_timestamp_ = packet.timestamp;
 #endif
         last_output_time_ = std::chrono::steady_clock::now();
+        OnAudioPacketsConsumed(1, true);
     });
 }
 
+// 音频包被播放或丢弃后调用，played 为 false 时丢弃对应的句子
+void Application::OnAudioPacketsConsumed(int count, bool played) {
+    if (count == 0) {
+        return;
+    }
+    decode_packets_consumed_ += count;
+    if (!played) {
+        std::lock_guard<std::mutex> lock(sentence_mutex_);
+        uint32_t consumed = decode_packets_consumed_;
+        while (!pending_sentences_.empty() && (int32_t)(consumed - pending_sentences_.front().start_packet) > 0) {
+            pending_sentences_.pop_front();
+        }
+        return;
+    }
+    RevealSentences(false);
+}
+
+// 按播放进度逐步显示句子：第一包音频播放时显示开头，之后按已播放的比例追加剩余文本
+void Application::RevealSentences(bool flush) {
+    auto display = Board::GetInstance().GetDisplay();
+    std::lock_guard<std::mutex> lock(sentence_mutex_);
+    uint32_t consumed = decode_packets_consumed_;
+    while (pending_sentences_.size() > MAX_PENDING_SENTENCES) {
+        auto& sentence = pending_sentences_.front();
+        if (sentence.revealed == 0) {
+            display->SetChatMessage("assistant", sentence.text.c_str());
+        } else {
+            display->AppendChatMessage(sentence.text.c_str() + sentence.revealed);
+        }
+        pending_sentences_.pop_front();
+    }
+
+    while (!pending_sentences_.empty()) {
+        auto& sentence = pending_sentences_.front();
+        int32_t played = consumed - sentence.start_packet;
+        if (!flush && played <= 0) {
+            break;
+        }
+
+        // 句子的音频到下一句开始为止，最后一句则以目前收到的音频为准
+        auto next = std::next(pending_sentences_.begin());
+        uint32_t end_packet = next != pending_sentences_.end() ? next->start_packet : decode_packets_queued_.load();
+        int32_t total = end_packet - sentence.start_packet;
+        size_t target = sentence.text.size();
+        if (!flush && played < total) {
+            target = sentence.text.size() * played / total;
+            // 对齐到 UTF-8 字符边界
+            while (target > 0 && (sentence.text[target] & 0xC0) == 0x80) {
+                target--;
+            }
+        }
+
+        if (target > sentence.revealed) {
+            auto chunk = sentence.text.substr(sentence.revealed, target - sentence.revealed);
+            if (sentence.revealed == 0) {
+                display->SetChatMessage("assistant", chunk.c_str());
+            } else {
+                display->AppendChatMessage(chunk.c_str());
+            }
+            sentence.revealed = target;
+        }
+        if (sentence.revealed < sentence.text.size()) {
+            break;
+        }
+        pending_sentences_.pop_front();
+    }
+}
+
 void Application::OnAudioInput() {
 #if CONFIG_USE_WAKE_WORD_DETECT
     if (wake_word_detect_.IsDetectionRunning()) {
@@ -935,10 +1227,14 @@ void Application::SetDeviceState(DeviceState state) {
 }
 
 void Application::ResetDecoder() {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::unique_lock<std::mutex> lock(mutex_);
     opus_decoder_->ResetState();
+    int dropped = audio_decode_queue_.size();
     audio_decode_queue_.clear();
     audio_decode_cv_.notify_all();
+    lock.unlock();
+    OnAudioPacketsConsumed(dropped, false);
+    lock.lock();
     last_output_time_ = std::chrono::steady_clock::now();
     auto codec = Board::GetInstance().GetAudioCodec();
     codec->EnableOutput(true);
@@ -949,6 +1245,7 @@ void Application::SetDecodeSampleRate(int sample_rate, int frame_duration) {
         return;
     }
 
+    HeapTagScope heap_tag_scope(kHeapTagOpus);
     opus_decoder_.reset();
     opus_decoder_ = std::make_unique<OpusDecoderWrapper>(sample_rate, 1, frame_duration);
 
@@ -1016,6 +1313,44 @@ void Application::SendMcpMessage(const std::string& payload) {
     });
 }
 
+bool Application::CanSendImage() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return image_channel_opened_;
+}
+
+// Called from the camera, the packets are sent by the main loop in turn with the audio packets
+bool Application::SendImage(ImageStreamPacket&& packet) {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (image_send_queue_.size() >= MAX_IMAGE_PACKETS_IN_QUEUE) {
+            if (!image_channel_opened_) {
+                return false;
+            }
+            image_send_cv_.wait_for(lock, std::chrono::milliseconds(100));
+        }
+        image_send_queue_.push_back(std::move(packet));
+    }
+    xEventGroupSetBits(event_group_, SEND_IMAGE_EVENT);
+    return true;
+}
+
+bool Application::WaitForImageResult(uint32_t image_id, std::string& result) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(IMAGE_RESULT_TIMEOUT_MS);
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        auto it = image_results_.find(image_id);
+        if (it != image_results_.end()) {
+            result = std::move(it->second);
+            image_results_.erase(it);
+            return true;
+        }
+        if (!image_channel_opened_ || std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        image_result_cv_.wait_for(lock, std::chrono::milliseconds(100));
+    }
+}
+
 void Application::SetAecMode(AecMode mode) {
     aec_mode_ = mode;
     Schedule([this]() {
@@ -12,6 +12,7 @@
 #include <vector>
 #include <condition_variable>
 #include <memory>
+#include <map>
 
 #include <opus_encoder.h>
 #include <opus_decoder.h>
@@ -29,6 +30,8 @@
 #define SCHEDULE_EVENT (1 << 0)
 #define SEND_AUDIO_EVENT (1 << 1)
 #define CHECK_NEW_VERSION_DONE_EVENT (1 << 2)
+#define SEND_IMAGE_EVENT (1 << 3)
+#define BOOT_INIT_DONE_EVENT (1 << 4)
 
 enum AecMode {
     kAecOff,
@@ -51,6 +54,23 @@ enum DeviceState {
 
 #define OPUS_FRAME_DURATION_MS 60
 #define MAX_AUDIO_PACKETS_IN_QUEUE (2400 / OPUS_FRAME_DURATION_MS)
+// 图片数据与音频交替发送，每轮主循环最多发送的图片包数，以及队列中最多缓存的图片包数
+#define MAX_IMAGE_PACKETS_PER_ROUND 2
+#define MAX_IMAGE_PACKETS_IN_QUEUE 16
+#define IMAGE_RESULT_TIMEOUT_MS 30000
+// 等待对应音频播放的 TTS 句子数上限，超出时直接显示最早的句子
+#define MAX_PENDING_SENTENCES 8
+// 启动阶段记录的最大数量
+#define MAX_BOOT_PHASES 16
+// 主循环中单个任务执行超过该时间即视为卡顿，期间无法发送音频和处理状态变化
+#define MAIN_LOOP_STALL_THRESHOLD_MS 50
+
+// 启动过程中的一个阶段，时间均从上电开始计算
+struct BootPhase {
+    const char* name;
+    int64_t start_us;
+    int64_t end_us;
+};
 
 class Application {
 public:
@@ -81,6 +101,10 @@ public:
     void SendMcpMessage(const std::string& payload);
     void SetAecMode(AecMode mode);
     AecMode GetAecMode() const { return aec_mode_; }
+    bool CanSendImage();
+    bool SendImage(ImageStreamPacket&& packet);
+    bool WaitForImageResult(uint32_t image_id, std::string& result);
+    std::string GetBootTimelineJson();
 
 private:
     Application();
@@ -104,7 +128,17 @@ private:
     bool voice_detected_ = false;
     bool busy_decoding_audio_ = false;
     int clock_ticks_ = 0;
+    // Main loop stall statistics, reset every time they are printed
+    std::atomic<uint32_t> main_loop_max_task_us_ = 0;
+    std::atomic<uint32_t> main_loop_stall_count_ = 0;
+    std::atomic<uint32_t> main_loop_stall_us_ = 0;
     TaskHandle_t check_new_version_task_handle_ = nullptr;
+    TaskHandle_t ota_task_handle_ = nullptr;
+    OtaTarget ota_target_;
+
+    // 启动时间线，网络和模型加载并行进行，各阶段可能重叠
+    std::mutex boot_mutex_;
+    std::vector<BootPhase> boot_phases_;
 
     // Audio encode / decode
     TaskHandle_t audio_loop_task_handle_ = nullptr;
@@ -113,6 +147,25 @@ private:
     std::list<AudioStreamPacket> audio_send_queue_;
     std::list<AudioStreamPacket> audio_decode_queue_;
     std::condition_variable audio_decode_cv_;
+    // 解码流中的音频包计数，TTS 文本按播放进度显示
+    std::atomic<uint32_t> decode_packets_queued_ = 0;
+    std::atomic<uint32_t> decode_packets_consumed_ = 0;
+
+    struct PendingSentence {
+        uint32_t start_packet;  // 句子之前已进入解码队列的音频包数
+        std::string text;
+        size_t revealed = 0;    // 已显示的字节数
+    };
+    std::mutex sentence_mutex_;
+    std::list<PendingSentence> pending_sentences_;
+
+    // Images uploaded over the audio channel, the producer waits when the queue is full
+    // image_channel_opened_ mirrors the audio channel state for the camera thread, guarded by mutex_
+    bool image_channel_opened_ = false;
+    std::list<ImageStreamPacket> image_send_queue_;
+    std::condition_variable image_send_cv_;
+    std::map<uint32_t, std::string> image_results_;
+    std::condition_variable image_result_cv_;
 
     // 新增：用于维护音频包的timestamp队列
     std::list<uint32_t> timestamp_queue_;
@@ -129,10 +182,16 @@ private:
     void MainEventLoop();
     void OnAudioInput();
     void OnAudioOutput();
+    void OnAudioPacketsConsumed(int count, bool played);
+    void RevealSentences(bool flush);
     void ReadAudio(std::vector<int16_t>& data, int sample_rate, int samples);
     void ResetDecoder();
     void SetDecodeSampleRate(int sample_rate, int frame_duration);
     void CheckNewVersion();
+    void StartBackgroundUpgrade();
+    void InitializeInBackground(AudioCodec* codec);
+    void RecordBootPhase(const char* name, int64_t start_us);
+    void PrintBootTimeline();
     void ShowActivationCode();
     void OnClockTimer();
     void SetListeningMode(ListeningMode mode);
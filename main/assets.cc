@@ -0,0 +1,100 @@
+#include "assets.h"
+
+#include <esp_log.h>
+#include <esp_rom_crc.h>
+#include <algorithm>
+#include <cstring>
+
+#define TAG "Assets"
+
+Assets::Assets() {
+    if (!Map()) {
+        entries_ = nullptr;
+        data_ = nullptr;
+        entry_count_ = 0;
+        if (mmap_handle_ != 0) {
+            esp_partition_munmap(mmap_handle_);
+            mmap_handle_ = 0;
+        }
+        return;
+    }
+    ESP_LOGI(TAG, "Assets version %s, %lu entries", version_.c_str(), entry_count_);
+}
+
+Assets::~Assets() {
+    if (mmap_handle_ != 0) {
+        esp_partition_munmap(mmap_handle_);
+    }
+}
+
+// 失败时只在这里输出一条错误日志，之后的查找都返回空
+bool Assets::Map() {
+    auto partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)ASSETS_PARTITION_SUBTYPE, ASSETS_PARTITION_LABEL);
+    if (partition == nullptr) {
+        ESP_LOGE(TAG, "Partition %s not found", ASSETS_PARTITION_LABEL);
+        return false;
+    }
+
+    const void* mapped = nullptr;
+    esp_err_t err = esp_partition_mmap(partition, 0, partition->size, ESP_PARTITION_MMAP_DATA, &mapped, &mmap_handle_);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to mmap partition: %s", esp_err_to_name(err));
+        return false;
+    }
+
+    auto header = static_cast<const AssetsHeader*>(mapped);
+    if (header->magic != ASSETS_MAGIC) {
+        ESP_LOGE(TAG, "Invalid magic 0x%08lx, assets not flashed?", header->magic);
+        return false;
+    }
+    if (header->format_version != ASSETS_FORMAT_VERSION) {
+        ESP_LOGE(TAG, "Unsupported format version %lu", header->format_version);
+        return false;
+    }
+    if (header->entry_count == 0) {
+        ESP_LOGE(TAG, "Assets bundle is empty");
+        return false;
+    }
+
+    size_t index_size = sizeof(AssetsHeader) + header->entry_count * sizeof(AssetsEntry);
+    if (index_size > partition->size || header->data_size > partition->size - index_size) {
+        ESP_LOGE(TAG, "Bundle size exceeds partition size");
+        return false;
+    }
+
+    // 分区可能只写了一部分，校验一次数据区，之后的查找不再访问索引以外的内容
+    auto data = static_cast<const uint8_t*>(mapped) + index_size;
+    if (esp_rom_crc32_le(0, data, header->data_size) != header->data_crc32) {
+        ESP_LOGE(TAG, "Data checksum mismatch");
+        return false;
+    }
+
+    auto entries = reinterpret_cast<const AssetsEntry*>(header + 1);
+    for (uint32_t i = 0; i < header->entry_count; i++) {
+        if (entries[i].offset > header->data_size || entries[i].size > header->data_size - entries[i].offset) {
+            ESP_LOGE(TAG, "Entry %.*s out of range", (int)sizeof(entries[i].name), entries[i].name);
+            return false;
+        }
+    }
+
+    version_.assign(header->version, strnlen(header->version, sizeof(header->version)));
+    entries_ = entries;
+    entry_count_ = header->entry_count;
+    data_ = data;
+    return true;
+}
+
+std::string_view Assets::Get(uint32_t id) const {
+    if (entries_ == nullptr) {
+        return {};
+    }
+    auto end = entries_ + entry_count_;
+    auto it = std::lower_bound(entries_, end, id, [](const AssetsEntry& entry, uint32_t id) {
+        return entry.id < id;
+    });
+    if (it == end || it->id != id) {
+        ESP_LOGW(TAG, "Asset 0x%08lx not found", id);
+        return {};
+    }
+    return std::string_view(reinterpret_cast<const char*>(data_ + it->offset), it->size);
+}
@@ -0,0 +1,91 @@
+#ifndef _ASSETS_H_
+#define _ASSETS_H_
+
+#include <string>
+#include <string_view>
+#include <mutex>
+#include <cstdint>
+
+#include <esp_partition.h>
+
+// 资源包格式，与 scripts/pack_assets.py 保持一致，所有字段均为小端
+#define ASSETS_MAGIC 0x53415a58 // "XZAS"
+#define ASSETS_FORMAT_VERSION 1
+#define ASSETS_PARTITION_LABEL "assets"
+// 自定义的 data 子类型，避免被工具当作 SPIFFS 镜像处理，与分区表中的 assets 分区一致
+#define ASSETS_PARTITION_SUBTYPE 0x40
+
+struct AssetsHeader {
+    uint32_t magic;
+    uint32_t format_version;
+    char version[32];           // 资源版本，与固件版本无关
+    uint32_t entry_count;
+    uint32_t data_size;         // 索引之后的数据区长度
+    uint32_t data_crc32;        // 数据区的 CRC32
+    uint32_t reserved;
+};
+
+// 索引按 id 升序排列，offset 相对于数据区起始位置
+struct AssetsEntry {
+    uint32_t id;
+    uint32_t offset;
+    uint32_t size;
+    char name[20];
+};
+
+// 通过 esp_partition_mmap 把 assets 分区映射到地址空间，查找结果直接指向 flash，不复制数据
+class Assets {
+public:
+    static Assets& GetInstance() {
+        static Assets instance;
+        return instance;
+    }
+    // 删除拷贝构造函数和赋值运算符
+    Assets(const Assets&) = delete;
+    Assets& operator=(const Assets&) = delete;
+
+    // 资源 id 为文件名的 FNV-1a 哈希
+    static constexpr uint32_t Hash(const char* name) {
+        uint32_t hash = 0x811c9dc5;
+        while (*name) {
+            hash = (hash ^ (uint8_t)*name++) * 0x01000193;
+        }
+        return hash;
+    }
+
+    bool IsValid() const { return entries_ != nullptr; }
+    const std::string& GetVersion() const { return version_; }
+    // 找不到时返回空的 string_view，分区不可用时不输出日志（Map 中已报告一次）
+    std::string_view Get(uint32_t id) const;
+    std::string_view Get(const char* name) const { return Get(Hash(name)); }
+
+private:
+    Assets();
+    ~Assets();
+
+    esp_partition_mmap_handle_t mmap_handle_ = 0;
+    const AssetsEntry* entries_ = nullptr;
+    const uint8_t* data_ = nullptr;
+    uint32_t entry_count_ = 0;
+    std::string version_;
+
+    bool Map();
+};
+
+// 按 id 延迟查找的资源引用，可以在需要 std::string_view 的地方直接使用，第一次使用时查找并缓存结果
+struct AssetRef {
+    uint32_t id;
+    const char* name;
+
+    constexpr AssetRef(const char* name) : id(Assets::Hash(name)), name(name) {}
+    operator std::string_view() const {
+        std::call_once(resolve_once_, [this]() { view_ = Assets::GetInstance().Get(id); });
+        return view_;
+    }
+
+private:
+    mutable std::once_flag resolve_once_;
+    mutable std::string_view view_;
+};
+
+#endif // _ASSETS_H_
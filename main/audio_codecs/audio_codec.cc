@@ -1,6 +1,7 @@
 #include "audio_codec.h"
 #include "board.h"
 #include "settings.h"
+#include "mcp_server.h"
 
 #include <esp_log.h>
 #include <cstring>
@@ -48,6 +49,8 @@ void AudioCodec::SetOutputVolume(int volume) {
     
     Settings settings("audio", true);
     settings.SetInt("output_volume", output_volume_);
+
+    McpServer::GetInstance().NotifyPropertyChanged("audio_speaker.volume", output_volume_);
 }
 
 void AudioCodec::EnableInput(bool enable) {
@@ -1,4 +1,5 @@
 #include "afe_audio_processor.h"
+#include "heap_tag.h"
 #include <esp_log.h>
 
 #define PROCESSOR_RUNNING 0x01
@@ -51,6 +52,7 @@ void AfeAudioProcessor::Initialize(AudioCodec* codec) {
     
     xTaskCreate([](void* arg) {
         auto this_ = (AfeAudioProcessor*)arg;
+        HeapTagger::SetTaskTag(xTaskGetCurrentTaskHandle(), kHeapTagAfe);
         this_->AudioProcessorTask();
         vTaskDelete(NULL);
     }, "audio_communication", 4096, this, 3, NULL);
@@ -1,5 +1,6 @@
 #include "wake_word_detect.h"
 #include "application.h"
+#include "heap_tag.h"
 
 #include <esp_log.h>
 #include <model_path.h>
@@ -68,6 +69,7 @@ void WakeWordDetect::Initialize(AudioCodec* codec) {
 
     xTaskCreate([](void* arg) {
         auto this_ = (WakeWordDetect*)arg;
+        HeapTagger::SetTaskTag(xTaskGetCurrentTaskHandle(), kHeapTagAfe);
         this_->AudioDetectionTask();
         vTaskDelete(NULL);
     }, "audio_detection", 4096, this, 3, nullptr);
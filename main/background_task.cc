@@ -1,4 +1,5 @@
 #include "background_task.h"
+#include "heap_tag.h"
 
 #include <esp_log.h>
 #include <esp_task_wdt.h>
@@ -10,6 +11,7 @@ BackgroundTask::BackgroundTask(uint32_t stack_size) {
         BackgroundTask* task = (BackgroundTask*)arg;
         task->BackgroundTaskLoop();
     }, "background_task", stack_size, this, 2, &background_task_handle_);
+    HeapTagger::SetTaskTag(background_task_handle_, kHeapTagBackgroundTask);
 }
 
 BackgroundTask::~BackgroundTask() {
@@ -27,6 +29,8 @@ void BackgroundTask::Schedule(std::function<void()> callback) {
         }
     }
     active_tasks_++;
+    // 排队中的回调也算在后台任务名下
+    HeapTagScope heap_tag_scope(kHeapTagBackgroundTask);
     main_tasks_.emplace_back([this, cb = std::move(callback)]() {
         cb();
         {
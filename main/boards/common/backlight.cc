@@ -1,5 +1,6 @@
 #include "backlight.h"
 #include "settings.h"
+#include "mcp_server.h"
 
 #include <esp_log.h>
 #include <driver/ledc.h>
@@ -65,6 +66,7 @@ void Backlight::SetBrightness(uint8_t brightness, bool permanent) {
         esp_timer_start_periodic(transition_timer_, 5 * 1000);
     }
     ESP_LOGI(TAG, "Set brightness to %d", brightness);
+    McpServer::GetInstance().NotifyPropertyChanged("screen.brightness", (int)brightness);
 }
 
 void Backlight::OnTransitionTimer() {
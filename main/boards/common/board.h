@@ -47,6 +47,8 @@ public:
     virtual Udp* CreateUdp() = 0;
     virtual void StartNetwork() = 0;
     virtual const char* GetNetworkStateIcon() = 0;
+    // 网络类型（wifi / cellular）、SSID 或运营商名称、信号强度（strong / medium / weak ...）
+    virtual void GetNetworkStatus(std::string& type, std::string& name, std::string& signal) = 0;
     virtual bool GetBatteryLevel(int &level, bool& charging, bool& discharging);
     virtual std::string GetJson();
     virtual void SetPowerSaveMode(bool enabled) = 0;
@@ -10,6 +10,16 @@ public:
     virtual bool SetHMirror(bool enabled) = 0;
     virtual bool SetVFlip(bool enabled) = 0;
     virtual std::string Explain(const std::string& question) = 0;
+    // 拍照并识别，保证识别的就是这次拍到的画面
+    virtual std::string CaptureAndExplain(const std::string& question) {
+        if (!Capture()) {
+            return "{\"success\": false, \"message\": \"Failed to capture photo\"}";
+        }
+        return Explain(question);
+    }
+    // 持续观察模式：低帧率采样，画面变化超过阈值时自动拍照识别
+    virtual bool StartWatching(int interval_ms, int threshold, const std::string& question) { return false; }
+    virtual void StopWatching() {}
 };
 
 #endif // CAMERA_H
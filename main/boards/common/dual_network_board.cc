@@ -92,6 +92,10 @@ const char* DualNetworkBoard::GetNetworkStateIcon() {
     return current_board_->GetNetworkStateIcon();
 }
 
+void DualNetworkBoard::GetNetworkStatus(std::string& type, std::string& name, std::string& signal) {
+    current_board_->GetNetworkStatus(type, name, signal);
+}
+
 void DualNetworkBoard::SetPowerSaveMode(bool enabled) {
     current_board_->SetPowerSaveMode(enabled);
 }
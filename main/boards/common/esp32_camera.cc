@@ -3,14 +3,79 @@
 #include "display.h"
 #include "board.h"
 #include "system_info.h"
+#include "application.h"
 
 #include <esp_log.h>
 #include <esp_heap_caps.h>
 #include <img_converters.h>
+#include <esp_timer.h>
+#include <cJSON.h>
 #include <cstring>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
 
 #define TAG "Esp32Camera"
 
+#define JPEG_QUALITY_MIN 20
+#define JPEG_QUALITY_MAX 90
+
+/*
+ * 按整数倍面积平均缩小 RGB565 图像，摄像头输出的像素为大端字节序，输出保持相同字节序。
+ * 按输出行处理，每次只累加 factor 行输入，访问是顺序的。
+ */
+static void DownscaleRgb565(const uint8_t* src, int src_width, int factor, uint8_t* dst, int dst_width, int dst_height) {
+    std::vector<uint32_t> sums(dst_width * 3);
+    const uint32_t area = factor * factor;
+    for (int y = 0; y < dst_height; y++) {
+        std::fill(sums.begin(), sums.end(), 0);
+        for (int dy = 0; dy < factor; dy++) {
+            const uint8_t* row = src + (size_t)(y * factor + dy) * src_width * 2;
+            for (int x = 0; x < dst_width; x++) {
+                uint32_t* sum = &sums[x * 3];
+                const uint8_t* p = row + x * factor * 2;
+                for (int dx = 0; dx < factor; dx++, p += 2) {
+                    uint16_t pixel = (p[0] << 8) | p[1];
+                    sum[0] += pixel >> 11;
+                    sum[1] += (pixel >> 5) & 0x3F;
+                    sum[2] += pixel & 0x1F;
+                }
+            }
+        }
+        uint8_t* out = dst + (size_t)y * dst_width * 2;
+        for (int x = 0; x < dst_width; x++) {
+            uint32_t* sum = &sums[x * 3];
+            uint16_t pixel = ((sum[0] / area) << 11) | ((sum[1] / area) << 5) | (sum[2] / area);
+            out[x * 2] = pixel >> 8;
+            out[x * 2 + 1] = pixel & 0xFF;
+        }
+    }
+}
+
+/*
+ * 将摄像头图像（大端 RGB565）按整数倍抽样缩小到预览尺寸，同时转换为小端字节序。
+ * 每次处理两个像素：拼成一个 32 位字后用一次位运算交换两个 16 位内的字节。
+ * dst_width 必须为偶数，以保证 32 位写入是对齐的。
+ */
+static void ConvertToPreview(const uint16_t* src, int src_width, int factor, uint16_t* dst, int dst_width, int dst_height) {
+    for (int y = 0; y < dst_height; y++) {
+        const uint16_t* row = src + (size_t)y * factor * src_width;
+        uint32_t* out = (uint32_t*)(dst + (size_t)y * dst_width);
+        if (factor == 1 && (src_width & 1) == 0) {
+            auto in = (const uint32_t*)row;
+            for (int x = 0; x < dst_width / 2; x++) {
+                uint32_t v = in[x];
+                out[x] = ((v & 0x00FF00FF) << 8) | ((v >> 8) & 0x00FF00FF);
+            }
+        } else {
+            for (int x = 0; x < dst_width / 2; x++) {
+                uint32_t v = row[x * 2 * factor] | ((uint32_t)row[(x * 2 + 1) * factor] << 16);
+                out[x] = ((v & 0x00FF00FF) << 8) | ((v >> 8) & 0x00FF00FF);
+            }
+        }
+    }
+}
+
 Esp32Camera::Esp32Camera(const camera_config_t& config) {
     // camera init
     esp_err_t err = esp_camera_init(&config); // 配置上面定义的参数
@@ -24,46 +89,12 @@ Esp32Camera::Esp32Camera(const camera_config_t& config) {
         s->set_hmirror(s, 0);  // 这里控制摄像头镜像 写1镜像 写0不镜像
     }
 
-    // 初始化预览图片的内存
-    memset(&preview_image_, 0, sizeof(preview_image_));
-    preview_image_.header.magic = LV_IMAGE_HEADER_MAGIC;
-    preview_image_.header.cf = LV_COLOR_FORMAT_RGB565;
-    preview_image_.header.flags = LV_IMAGE_FLAGS_ALLOCATED | LV_IMAGE_FLAGS_MODIFIABLE;
-
-    switch (config.frame_size) {
-        case FRAMESIZE_SVGA:
-            preview_image_.header.w = 800;
-            preview_image_.header.h = 600;
-            break;
-        case FRAMESIZE_VGA:
-            preview_image_.header.w = 640;
-            preview_image_.header.h = 480;
-            break;
-        case FRAMESIZE_QVGA:
-            preview_image_.header.w = 320;
-            preview_image_.header.h = 240;
-            break;
-        case FRAMESIZE_128X128:
-            preview_image_.header.w = 128;
-            preview_image_.header.h = 128;
-            break;
-        case FRAMESIZE_240X240:
-            preview_image_.header.w = 240;
-            preview_image_.header.h = 240;
-            break;
-        default:
-            ESP_LOGE(TAG, "Unsupported frame size: %d, image preview will not be shown", config.frame_size);
-            preview_image_.data_size = 0;
-            preview_image_.data = nullptr;
-            return;
-    }
-
-    preview_image_.header.stride = preview_image_.header.w * 2;
-    preview_image_.data_size = preview_image_.header.w * preview_image_.header.h * 2;
-    preview_image_.data = (uint8_t*)heap_caps_malloc(preview_image_.data_size, MALLOC_CAP_SPIRAM);
-    if (preview_image_.data == nullptr) {
-        ESP_LOGE(TAG, "Failed to allocate memory for preview image");
-        return;
+    // 预览图片的内存在第一次拍照时按显示屏尺寸分配
+    for (auto& image : preview_images_) {
+        memset(&image, 0, sizeof(image));
+        image.header.magic = LV_IMAGE_HEADER_MAGIC;
+        image.header.cf = LV_COLOR_FORMAT_RGB565;
+        image.header.flags = LV_IMAGE_FLAGS_ALLOCATED | LV_IMAGE_FLAGS_MODIFIABLE;
     }
 }
 
@@ -72,9 +103,11 @@ Esp32Camera::~Esp32Camera() {
         esp_camera_fb_return(fb_);
         fb_ = nullptr;
     }
-    if (preview_image_.data) {
-        heap_caps_free((void*)preview_image_.data);
-        preview_image_.data = nullptr;
+    for (auto& image : preview_images_) {
+        if (image.data) {
+            heap_caps_free((void*)image.data);
+            image.data = nullptr;
+        }
     }
     esp_camera_deinit();
 }
@@ -84,14 +117,9 @@ void Esp32Camera::SetExplainUrl(const std::string& url, const std::string& token
     explain_token_ = token;
 }
 
-bool Esp32Camera::Capture() {
-    if (encoder_thread_.joinable()) {
-        encoder_thread_.join();
-    }
-
-    int frames_to_get = 2;
-    // Try to get a stable frame
-    for (int i = 0; i < frames_to_get; i++) {
+// Replace fb_ with a new frame, the caller must hold mutex_
+bool Esp32Camera::GetFrames(int count) {
+    for (int i = 0; i < count; i++) {
         if (fb_ != nullptr) {
             esp_camera_fb_return(fb_);
         }
@@ -101,31 +129,69 @@ bool Esp32Camera::Capture() {
             return false;
         }
     }
+    return true;
+}
 
-    // 如果预览图片 buffer 为空，则跳过预览
-    // 但仍返回 true，因为此时图像可以上传至服务器
-    if (preview_image_.data_size == 0) {
-        ESP_LOGW(TAG, "Skip preview because of unsupported frame size");
-        return true;
+bool Esp32Camera::Capture() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (encoder_thread_.joinable()) {
+        encoder_thread_.join();
     }
-    if (preview_image_.data == nullptr) {
-        ESP_LOGE(TAG, "Preview image data is not initialized");
+
+    // Try to get a stable frame
+    if (!GetFrames(2)) {
+        return false;
+    }
+
+    // 预览只支持 RGB565 格式，但仍返回 true，因为此时图像可以上传至服务器
+    if (fb_->format != PIXFORMAT_RGB565) {
+        ESP_LOGW(TAG, "Skip preview because of unsupported pixel format");
         return true;
     }
-    // 显示预览图片
     auto display = Board::GetInstance().GetDisplay();
-    if (display != nullptr) {
-        auto src = (uint16_t*)fb_->buf;
-        auto dst = (uint16_t*)preview_image_.data;
-        size_t pixel_count = fb_->len / 2;
-        for (size_t i = 0; i < pixel_count; i++) {
-            // 交换每个16位字内的字节
-            dst[i] = __builtin_bswap16(src[i]);
+    if (display == nullptr || !InitializePreviewImages(display)) {
+        return true;
+    }
+
+    // 写入另一块缓冲区，上一帧仍可由 LVGL 绘制
+    auto& image = preview_images_[preview_index_];
+    ConvertToPreview((const uint16_t*)fb_->buf, fb_->width, preview_factor_,
+        (uint16_t*)image.data, image.header.w, image.header.h);
+    display->SetPreviewImage(&image);
+    preview_index_ ^= 1;
+    return true;
+}
+
+// 预览显示为屏幕宽度的一半，按整数倍缩小到该尺寸后 LVGL 几乎不需要再缩放
+bool Esp32Camera::InitializePreviewImages(Display* display) {
+    if (preview_images_[0].data != nullptr) {
+        return true;
+    }
+
+    int preview_width = std::max(display->width() / 2, 1);
+    preview_factor_ = std::max((int)fb_->width / preview_width, 1);
+    // 宽度取偶数，保证每行都按 4 字节对齐
+    uint32_t width = (fb_->width / preview_factor_) & ~1;
+    uint32_t height = fb_->height / preview_factor_;
+    for (auto& image : preview_images_) {
+        image.header.w = width;
+        image.header.h = height;
+        image.header.stride = width * 2;
+        image.data_size = width * height * 2;
+        image.data = (uint8_t*)heap_caps_malloc(image.data_size, MALLOC_CAP_SPIRAM);
+        if (image.data == nullptr) {
+            ESP_LOGE(TAG, "Failed to allocate memory for preview image");
+            for (auto& allocated : preview_images_) {
+                heap_caps_free((void*)allocated.data);
+                allocated.data = nullptr;
+            }
+            return false;
         }
-        display->SetPreviewImage(&preview_image_);
     }
+    ESP_LOGI(TAG, "Preview image %lux%lu, downscale factor %d", (unsigned long)width, (unsigned long)height, preview_factor_);
     return true;
 }
+
 bool Esp32Camera::SetHMirror(bool enabled) {
     sensor_t *s = esp_camera_sensor_get();
     if (s == nullptr) {
@@ -160,55 +226,42 @@ bool Esp32Camera::SetVFlip(bool enabled) {
     return true;
 }
 
-/**
- * @brief 将摄像头捕获的图像发送到远程服务器进行AI分析和解释
- * 
- * 该函数将当前摄像头缓冲区中的图像编码为JPEG格式，并通过HTTP POST请求
- * 以multipart/form-data的形式发送到指定的解释服务器。服务器将根据提供的
- * 问题对图像进行AI分析并返回结果。
- * 
- * 实现特点：
- * - 使用独立线程编码JPEG，与主线程分离
- * - 采用分块传输编码(chunked transfer encoding)优化内存使用
- * - 通过队列机制实现编码线程和发送线程的数据同步
- * - 支持设备ID、客户端ID和认证令牌的HTTP头部配置
- * 
- * @param question 要向AI提出的关于图像的问题，将作为表单字段发送
- * @return std::string 服务器返回的JSON格式响应字符串
- *         成功时包含AI分析结果，失败时包含错误信息
- *         格式示例：{"success": true, "result": "分析结果"}
- *                  {"success": false, "message": "错误信息"}
- * 
- * @note 调用此函数前必须先调用SetExplainUrl()设置服务器URL
- * @note 函数会等待之前的编码线程完成后再开始新的处理
- * @warning 如果摄像头缓冲区为空或网络连接失败，将返回错误信息
- */
-std::string Esp32Camera::Explain(const std::string& question) {
-    if (explain_url_.empty()) {
-        return "{\"success\": false, \"message\": \"Image explain URL or token is not set\"}";
+size_t Esp32Camera::GetJpegBudget() {
+    if (Board::GetInstance().GetBoardType() == "ml307") {
+        return CONFIG_CAMERA_EXPLAIN_JPEG_BUDGET_4G;
     }
+    return CONFIG_CAMERA_EXPLAIN_JPEG_BUDGET_WIFI;
+}
 
-    // 创建局部的 JPEG 队列, 40 entries is about to store 512 * 40 = 20480 bytes of JPEG data
-    QueueHandle_t jpeg_queue = xQueueCreate(40, sizeof(JpegChunk));
-    if (jpeg_queue == nullptr) {
-        ESP_LOGE(TAG, "Failed to create JPEG queue");
-        return "{\"success\": false, \"message\": \"Failed to create JPEG queue\"}";
+// JPEG 是边编码边上传的，无法重新编码，因此根据本次的大小调整下一次的质量
+void Esp32Camera::UpdateJpegQuality(size_t jpeg_size, size_t budget) {
+    int quality = jpeg_quality_;
+    if (jpeg_size > budget * 11 / 10) {
+        // 超出预算越多，质量下降越多
+        quality -= std::max(5, (int)(jpeg_size * 10 / budget) - 10);
+    } else if (jpeg_size < budget * 7 / 10) {
+        quality += 5;
+    }
+    quality = std::clamp(quality, JPEG_QUALITY_MIN, JPEG_QUALITY_MAX);
+    if (quality != jpeg_quality_) {
+        ESP_LOGI(TAG, "JPEG size %u, budget %u, quality %d -> %d", jpeg_size, budget, jpeg_quality_, quality);
+        jpeg_quality_ = quality;
     }
+}
 
-    // We spawn a thread to encode the image to JPEG
-    encoder_thread_ = std::thread([this, jpeg_queue]() {
-        frame2jpg_cb(fb_, 80, [](void* arg, size_t index, const void* data, size_t len) -> unsigned int {
-            auto jpeg_queue = (QueueHandle_t)arg;
-            JpegChunk chunk = {
-                .data = (uint8_t*)heap_caps_aligned_alloc(16, len, MALLOC_CAP_SPIRAM),
-                .len = len
-            };
-            memcpy(chunk.data, data, len);
-            xQueueSend(jpeg_queue, &chunk, portMAX_DELAY);
-            return len;
-        }, jpeg_queue);
-    });
+// 丢弃队列中剩余的 JPEG 数据，直到编码线程发出最后一块
+static void DrainJpegQueue(QueueHandle_t jpeg_queue) {
+    JpegChunk chunk;
+    while (xQueueReceive(jpeg_queue, &chunk, portMAX_DELAY) == pdPASS) {
+        if (chunk.data != nullptr) {
+            heap_caps_free(chunk.data);
+        } else {
+            break;
+        }
+    }
+}
 
+bool Esp32Camera::UploadByHttp(const std::string& question, QueueHandle_t jpeg_queue, size_t& total_sent, std::string& result) {
     auto http = Board::GetInstance().CreateHttp();
     // 构造multipart/form-data请求体
     std::string boundary = "----ESP32_CAMERA_BOUNDARY";
@@ -241,18 +294,10 @@ std::string Esp32Camera::Explain(const std::string& question) {
     http->SetHeader("Transfer-Encoding", "chunked");
     if (!http->Open("POST", explain_url_)) {
         ESP_LOGE(TAG, "Failed to connect to explain URL");
-        // Clear the queue
-        encoder_thread_.join();
-        JpegChunk chunk;
-        while (xQueueReceive(jpeg_queue, &chunk, portMAX_DELAY) == pdPASS) {
-            if (chunk.data != nullptr) {
-                heap_caps_free(chunk.data);
-            } else {
-                break;
-            }
-        }
-        vQueueDelete(jpeg_queue);
-        return "{\"success\": false, \"message\": \"Failed to connect to explain URL\"}";
+        // Clear the queue, the encoder thread may be blocked on it
+        DrainJpegQueue(jpeg_queue);
+        result = "{\"success\": false, \"message\": \"Failed to connect to explain URL\"}";
+        return false;
     }
     
     // 第一块：question字段
@@ -262,7 +307,6 @@ std::string Esp32Camera::Explain(const std::string& question) {
     http->Write(file_header.c_str(), file_header.size());
     
     // 第三块：JPEG数据
-    size_t total_sent = 0;
     while (true) {
         JpegChunk chunk;
         if (xQueueReceive(jpeg_queue, &chunk, portMAX_DELAY) != pdPASS) {
@@ -276,10 +320,6 @@ std::string Esp32Camera::Explain(const std::string& question) {
         total_sent += chunk.len;
         heap_caps_free(chunk.data);
     }
-    // Wait for the encoder thread to finish
-    encoder_thread_.join();
-    // 清理队列
-    vQueueDelete(jpeg_queue);
 
     // 第四块：multipart尾部
     http->Write(multipart_footer.c_str(), multipart_footer.size());
@@ -289,12 +329,340 @@ std::string Esp32Camera::Explain(const std::string& question) {
 
     if (http->GetStatusCode() != 200) {
         ESP_LOGE(TAG, "Failed to upload photo, status code: %d", http->GetStatusCode());
-        return "{\"success\": false, \"message\": \"Failed to upload photo\"}";
+        result = "{\"success\": false, \"message\": \"Failed to upload photo\"}";
+        return false;
     }
 
-    std::string result = http->ReadAll();
+    result = http->ReadAll();
     http->Close();
+    return true;
+}
 
-    ESP_LOGI(TAG, "Explain image size=%dx%d, compressed size=%d, question=%s\n%s", fb_->width, fb_->height, total_sent, question.c_str(), result.c_str());
+// 通过音频通道上传：开始消息、JPEG 数据块、结束消息，由主循环与音频包交替发送，服务器以 image 消息返回结果
+bool Esp32Camera::UploadByAudioChannel(const std::string& question, QueueHandle_t jpeg_queue, size_t& total_sent, std::string& result) {
+    auto& app = Application::GetInstance();
+    uint32_t image_id = ++image_id_;
+
+    ImageStreamPacket start_packet;
+    start_packet.type = kImagePacketStart;
+    start_packet.image_id = image_id;
+    start_packet.question = question;
+    bool sent = app.SendImage(std::move(start_packet));
+
+    while (true) {
+        JpegChunk chunk;
+        if (xQueueReceive(jpeg_queue, &chunk, portMAX_DELAY) != pdPASS) {
+            ESP_LOGE(TAG, "Failed to receive JPEG chunk");
+            break;
+        }
+        if (chunk.data == nullptr) {
+            break; // The last chunk
+        }
+        // 发送失败后仍需取完队列，避免编码线程阻塞
+        if (sent) {
+            ImageStreamPacket packet;
+            packet.image_id = image_id;
+            packet.payload.assign(chunk.data, chunk.data + chunk.len);
+            sent = app.SendImage(std::move(packet));
+            total_sent += chunk.len;
+        }
+        heap_caps_free(chunk.data);
+    }
+
+    if (sent) {
+        ImageStreamPacket end_packet;
+        end_packet.type = kImagePacketEnd;
+        end_packet.image_id = image_id;
+        end_packet.size = total_sent;
+        sent = app.SendImage(std::move(end_packet));
+    }
+    if (!sent) {
+        ESP_LOGE(TAG, "Failed to send photo over the audio channel");
+        result = "{\"success\": false, \"message\": \"Failed to upload photo\"}";
+        return false;
+    }
+
+    if (!app.WaitForImageResult(image_id, result)) {
+        ESP_LOGE(TAG, "No explain result for image %u", (unsigned int)image_id);
+        result = "{\"success\": false, \"message\": \"No explain result from server\"}";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 将摄像头捕获的图像发送到远程服务器进行AI分析和解释
+ * 
+ * 该函数将当前摄像头缓冲区中的图像编码为JPEG格式，如果音频通道已打开且支持图片，
+ * 则通过该通道与音频交替上传，否则通过HTTP POST请求
+ * 以multipart/form-data的形式发送到指定的解释服务器。服务器将根据提供的
+ * 问题对图像进行AI分析并返回结果。
+ * 
+ * 实现特点：
+ * - 使用独立线程编码JPEG，与主线程分离
+ * - 采用分块传输编码(chunked transfer encoding)优化内存使用
+ * - 通过队列机制实现编码线程和发送线程的数据同步
+ * - 支持设备ID、客户端ID和认证令牌的HTTP头部配置
+ * 
+ * @param question 要向AI提出的关于图像的问题，将作为表单字段发送
+ * @return std::string 服务器返回的JSON格式响应字符串
+ *         成功时包含AI分析结果，失败时包含错误信息
+ *         格式示例：{"success": true, "result": "分析结果"}
+ *                  {"success": false, "message": "错误信息"}
+ * 
+ * @note 不使用音频通道时，调用此函数前必须先调用SetExplainUrl()设置服务器URL
+ * @note 函数会等待之前的编码线程完成后再开始新的处理
+ * @warning 如果摄像头缓冲区为空或网络连接失败，将返回错误信息
+ */
+std::string Esp32Camera::Explain(const std::string& question) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fb_ == nullptr) {
+        return "{\"success\": false, \"message\": \"No photo captured\"}";
+    }
+
+    // 音频通道已打开且支持图片时，直接通过该通道上传，省去新建 HTTPS 连接
+    bool use_audio_channel = Application::GetInstance().CanSendImage();
+    if (!use_audio_channel && explain_url_.empty()) {
+        return "{\"success\": false, \"message\": \"Image explain URL or token is not set\"}";
+    }
+
+    // 创建局部的 JPEG 队列, 40 entries is about to store 512 * 40 = 20480 bytes of JPEG data
+    QueueHandle_t jpeg_queue = xQueueCreate(40, sizeof(JpegChunk));
+    if (jpeg_queue == nullptr) {
+        ESP_LOGE(TAG, "Failed to create JPEG queue");
+        return "{\"success\": false, \"message\": \"Failed to create JPEG queue\"}";
+    }
+
+    // 视觉模型不需要高分辨率，RGB565 图像先按整数倍缩小再编码，减少编码和上传的数据量
+    int64_t start_time = esp_timer_get_time();
+    int width = fb_->width;
+    int height = fb_->height;
+    uint8_t* scaled = nullptr;
+    if (fb_->format == PIXFORMAT_RGB565 && fb_->width > CONFIG_CAMERA_EXPLAIN_MAX_WIDTH) {
+        int factor = (fb_->width + CONFIG_CAMERA_EXPLAIN_MAX_WIDTH - 1) / CONFIG_CAMERA_EXPLAIN_MAX_WIDTH;
+        scaled = (uint8_t*)heap_caps_malloc((fb_->width / factor) * (fb_->height / factor) * 2, MALLOC_CAP_SPIRAM);
+        if (scaled != nullptr) {
+            width = fb_->width / factor;
+            height = fb_->height / factor;
+            DownscaleRgb565(fb_->buf, fb_->width, factor, scaled, width, height);
+        } else {
+            ESP_LOGW(TAG, "Failed to allocate memory for the scaled image, use the original size");
+        }
+    }
+    int quality = jpeg_quality_;
+    int64_t encode_start_time = esp_timer_get_time();
+    int64_t encode_end_time = encode_start_time;
+
+    // We spawn a thread to encode the image to JPEG
+    encoder_thread_ = std::thread([this, jpeg_queue, scaled, width, height, quality, &encode_end_time]() {
+        auto on_jpeg_chunk = [](void* arg, size_t index, const void* data, size_t len) -> unsigned int {
+            auto jpeg_queue = (QueueHandle_t)arg;
+            JpegChunk chunk = {
+                .data = (uint8_t*)heap_caps_aligned_alloc(16, len, MALLOC_CAP_SPIRAM),
+                .len = len
+            };
+            memcpy(chunk.data, data, len);
+            xQueueSend(jpeg_queue, &chunk, portMAX_DELAY);
+            return len;
+        };
+        if (scaled != nullptr) {
+            fmt2jpg_cb(scaled, width * height * 2, width, height, PIXFORMAT_RGB565, quality, on_jpeg_chunk, jpeg_queue);
+            heap_caps_free(scaled);
+        } else {
+            frame2jpg_cb(fb_, quality, on_jpeg_chunk, jpeg_queue);
+        }
+        encode_end_time = esp_timer_get_time();
+    });
+
+    int64_t upload_start_time = esp_timer_get_time();
+    size_t total_sent = 0;
+    std::string result;
+    bool success;
+    if (use_audio_channel) {
+        success = UploadByAudioChannel(question, jpeg_queue, total_sent, result);
+    } else {
+        success = UploadByHttp(question, jpeg_queue, total_sent, result);
+    }
+    // Wait for the encoder thread to finish
+    encoder_thread_.join();
+    // 清理队列
+    vQueueDelete(jpeg_queue);
+    if (!success) {
+        return result;
+    }
+    int64_t end_time = esp_timer_get_time();
+
+    UpdateJpegQuality(total_sent, GetJpegBudget());
+    ESP_LOGI(TAG, "Explain image size=%dx%d, quality=%d, compressed size=%d, question=%s\n%s", width, height, quality, total_sent, question.c_str(), result.c_str());
+
+    // 将图片参数和各阶段耗时附加到返回的 JSON 中
+    auto root = cJSON_Parse(result.c_str());
+    if (cJSON_IsObject(root)) {
+        auto image = cJSON_CreateObject();
+        cJSON_AddNumberToObject(image, "width", width);
+        cJSON_AddNumberToObject(image, "height", height);
+        cJSON_AddNumberToObject(image, "quality", quality);
+        cJSON_AddNumberToObject(image, "bytes", total_sent);
+        cJSON_AddNumberToObject(image, "encode_start_ms", (encode_start_time - start_time) / 1000);
+        cJSON_AddNumberToObject(image, "encode_ms", (encode_end_time - encode_start_time) / 1000);
+        cJSON_AddNumberToObject(image, "upload_ms", (end_time - upload_start_time) / 1000);
+        cJSON_AddItemToObject(root, "image", image);
+        auto json_str = cJSON_PrintUnformatted(root);
+        result = json_str;
+        cJSON_free(json_str);
+    }
+    cJSON_Delete(root);
     return result;
 }
+
+// 计算大端 RGB565 图像的亮度网格，每个格子只抽样 4x4 个像素
+static void ComputeLumaGrid(const camera_fb_t* fb, uint8_t* grid) {
+    const int samples = 4;
+    int cell_width = fb->width / CAMERA_WATCH_GRID_WIDTH;
+    int cell_height = fb->height / CAMERA_WATCH_GRID_HEIGHT;
+    for (int gy = 0; gy < CAMERA_WATCH_GRID_HEIGHT; gy++) {
+        for (int gx = 0; gx < CAMERA_WATCH_GRID_WIDTH; gx++) {
+            uint32_t sum = 0;
+            for (int sy = 0; sy < samples; sy++) {
+                int y = gy * cell_height + sy * cell_height / samples;
+                for (int sx = 0; sx < samples; sx++) {
+                    int x = gx * cell_width + sx * cell_width / samples;
+                    const uint8_t* p = fb->buf + ((size_t)y * fb->width + x) * 2;
+                    uint16_t pixel = (p[0] << 8) | p[1];
+                    // Y = 0.299R + 0.587G + 0.114B，分量先扩展到 8 位
+                    uint32_t r = (pixel >> 11) << 3;
+                    uint32_t g = ((pixel >> 5) & 0x3F) << 2;
+                    uint32_t b = (pixel & 0x1F) << 3;
+                    sum += (r * 77 + g * 150 + b * 29) >> 8;
+                }
+            }
+            grid[gy * CAMERA_WATCH_GRID_WIDTH + gx] = sum / (samples * samples);
+        }
+    }
+}
+
+std::string Esp32Camera::CaptureAndExplain(const std::string& question) {
+    std::lock_guard<std::mutex> lock(photo_mutex_);
+    if (!Capture()) {
+        return "{\"success\": false, \"message\": \"Failed to capture photo\"}";
+    }
+    return Explain(question);
+}
+
+bool Esp32Camera::StartWatching(int interval_ms, int threshold, const std::string& question) {
+    std::lock_guard<std::mutex> lock(watch_mutex_);
+    watch_interval_ms_ = interval_ms;
+    watch_threshold_ = threshold;
+    watch_question_ = question;
+    watching_ = true;
+    ESP_LOGI(TAG, "Start watching, interval=%dms, threshold=%d", interval_ms, threshold);
+
+    // 观察任务仍在运行时只更新参数，并唤醒它按新的间隔重新计时
+    if (watch_task_ != nullptr) {
+        xTaskNotifyGive(watch_task_);
+        return true;
+    }
+    auto ret = xTaskCreate([](void* arg) {
+        Esp32Camera* camera = (Esp32Camera*)arg;
+        camera->WatchLoop();
+        vTaskDelete(NULL);
+    }, "camera_watch", 4096 * 2, this, 1, &watch_task_);
+    if (ret != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create camera watch task");
+        watch_task_ = nullptr;
+        watching_ = false;
+        return false;
+    }
+    return true;
+}
+
+void Esp32Camera::StopWatching() {
+    std::lock_guard<std::mutex> lock(watch_mutex_);
+    watching_ = false;
+    // 唤醒等待中的观察任务，使其立即退出
+    if (watch_task_ != nullptr) {
+        xTaskNotifyGive(watch_task_);
+    }
+    ESP_LOGI(TAG, "Stop watching");
+}
+
+/*
+ * 观察模式：按较低的帧率采样，只计算缩小后的亮度网格并与上次识别时的画面比较，
+ * 平均亮度差超过阈值时才编码上传识别，并通过 MCP 通知服务器识别结果。
+ */
+void Esp32Camera::WatchLoop() {
+    std::vector<uint8_t> baseline;
+    std::vector<uint8_t> grid(CAMERA_WATCH_GRID_WIDTH * CAMERA_WATCH_GRID_HEIGHT);
+    while (true) {
+        int interval_ms;
+        int threshold;
+        std::string question;
+        {
+            std::lock_guard<std::mutex> lock(watch_mutex_);
+            if (!watching_) {
+                watch_task_ = nullptr;
+                break;
+            }
+            interval_ms = watch_interval_ms_;
+            threshold = watch_threshold_;
+            question = watch_question_;
+        }
+        // 被通知时说明参数已更新或已停止，回到开头重新读取
+        if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(interval_ms)) > 0) {
+            continue;
+        }
+
+        // 采样到识别完成期间不让拍照工具替换 fb_
+        std::unique_lock<std::mutex> photo_lock(photo_mutex_);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!GetFrames(1)) {
+                continue;
+            }
+            if (fb_->format != PIXFORMAT_RGB565) {
+                ESP_LOGE(TAG, "Watching only supports RGB565 frames");
+                StopWatching();
+                continue;
+            }
+            ComputeLumaGrid(fb_, grid.data());
+        }
+
+        if (baseline.empty()) {
+            baseline = grid;
+            continue;
+        }
+        int score = 0;
+        for (size_t i = 0; i < grid.size(); i++) {
+            score += std::abs(grid[i] - baseline[i]);
+        }
+        score /= grid.size();
+        if (score < threshold) {
+            continue;
+        }
+
+        // 没有 MCP 会话时不上传识别，保留基准画面，会话建立后再报告变化
+        if (!McpServer::GetInstance().IsSessionOpen()) {
+            continue;
+        }
+
+        ESP_LOGI(TAG, "Scene changed, score=%d", score);
+        baseline = grid;
+        auto result = Explain(question);
+        photo_lock.unlock();
+        auto result_json = cJSON_Parse(result.c_str());
+        auto success = cJSON_GetObjectItem(result_json, "success");
+        if (!cJSON_IsObject(result_json) || cJSON_IsFalse(success)) {
+            ESP_LOGW(TAG, "Failed to explain the changed scene: %s", result.c_str());
+            cJSON_Delete(result_json);
+            continue;
+        }
+
+        auto params = cJSON_CreateObject();
+        cJSON_AddNumberToObject(params, "score", score);
+        cJSON_AddItemToObject(params, "result", result_json);
+        auto json_str = cJSON_PrintUnformatted(params);
+        McpServer::GetInstance().SendNotification("notifications/camera_scene_changed", json_str);
+        cJSON_free(json_str);
+        cJSON_Delete(params);
+    }
+}
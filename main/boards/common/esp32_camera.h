@@ -5,12 +5,21 @@
 #include <lvgl.h>
 #include <thread>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 #include <freertos/FreeRTOS.h>
 #include <freertos/queue.h>
+#include <freertos/task.h>
 
 #include "camera.h"
 
+class Display;
+
+// 观察模式下用于比较画面变化的亮度网格大小
+#define CAMERA_WATCH_GRID_WIDTH 16
+#define CAMERA_WATCH_GRID_HEIGHT 12
+
 struct JpegChunk {
     uint8_t* data;
     size_t len;
@@ -19,10 +28,38 @@ struct JpegChunk {
 class Esp32Camera : public Camera {
 private:
     camera_fb_t* fb_ = nullptr;
-    lv_img_dsc_t preview_image_;
+    // 保护 fb_，拍照、识别和观察模式的采样不能同时进行
+    std::mutex mutex_;
+    // 从拍照到识别完成期间持有，观察模式不能在中间替换 fb_
+    std::mutex photo_mutex_;
+    // 双缓冲预览图片，拍摄下一帧时上一帧仍可显示
+    lv_img_dsc_t preview_images_[2];
+    int preview_index_ = 0;
+    int preview_factor_ = 1;
     std::string explain_url_;
     std::string explain_token_;
     std::thread encoder_thread_;
+    // 根据上次上传的图片大小自动调整的 JPEG 编码质量
+    int jpeg_quality_ = 80;
+
+    // 通过音频通道上传的图片编号
+    uint32_t image_id_ = 0;
+
+    bool InitializePreviewImages(Display* display);
+    // 观察模式
+    std::mutex watch_mutex_;
+    TaskHandle_t watch_task_ = nullptr;
+    bool watching_ = false;
+    int watch_interval_ms_ = 0;
+    int watch_threshold_ = 0;
+    std::string watch_question_;
+
+    bool GetFrames(int count);
+    void WatchLoop();
+    size_t GetJpegBudget();
+    bool UploadByHttp(const std::string& question, QueueHandle_t jpeg_queue, size_t& total_sent, std::string& result);
+    bool UploadByAudioChannel(const std::string& question, QueueHandle_t jpeg_queue, size_t& total_sent, std::string& result);
+    void UpdateJpegQuality(size_t jpeg_size, size_t budget);
 
 public:
     Esp32Camera(const camera_config_t& config);
@@ -34,6 +71,9 @@ public:
     virtual bool SetHMirror(bool enabled) override;
     virtual bool SetVFlip(bool enabled) override;
     virtual std::string Explain(const std::string& question);
+    virtual std::string CaptureAndExplain(const std::string& question) override;
+    virtual bool StartWatching(int interval_ms, int threshold, const std::string& question) override;
+    virtual void StopWatching() override;
 };
 
 #endif // ESP32_CAMERA_H
\ No newline at end of file
@@ -121,6 +121,25 @@ void Ml307Board::SetPowerSaveMode(bool enabled) {
     // TODO: Implement power save mode for ML307
 }
 
+void Ml307Board::GetNetworkStatus(std::string& type, std::string& name, std::string& signal) {
+    type = "cellular";
+    name = modem_.GetCarrierName();
+    int csq = modem_.GetCsq();
+    if (csq == -1) {
+        signal = "unknown";
+    } else if (csq >= 0 && csq <= 14) {
+        signal = "very weak";
+    } else if (csq >= 15 && csq <= 19) {
+        signal = "weak";
+    } else if (csq >= 20 && csq <= 24) {
+        signal = "medium";
+    } else if (csq >= 25 && csq <= 31) {
+        signal = "strong";
+    } else {
+        signal.clear();
+    }
+}
+
 std::string Ml307Board::GetDeviceStatusJson() {
     /*
      * 返回设备状态JSON
@@ -180,20 +199,13 @@ std::string Ml307Board::GetDeviceStatusJson() {
     }
 
     // Network
+    std::string type, name, signal;
+    GetNetworkStatus(type, name, signal);
     auto network = cJSON_CreateObject();
-    cJSON_AddStringToObject(network, "type", "cellular");
-    cJSON_AddStringToObject(network, "carrier", modem_.GetCarrierName().c_str());
-    int csq = modem_.GetCsq();
-    if (csq == -1) {
-        cJSON_AddStringToObject(network, "signal", "unknown");
-    } else if (csq >= 0 && csq <= 14) {
-        cJSON_AddStringToObject(network, "signal", "very weak");
-    } else if (csq >= 15 && csq <= 19) {
-        cJSON_AddStringToObject(network, "signal", "weak");
-    } else if (csq >= 20 && csq <= 24) {
-        cJSON_AddStringToObject(network, "signal", "medium");
-    } else if (csq >= 25 && csq <= 31) {
-        cJSON_AddStringToObject(network, "signal", "strong");
+    cJSON_AddStringToObject(network, "type", type.c_str());
+    cJSON_AddStringToObject(network, "carrier", name.c_str());
+    if (!signal.empty()) {
+        cJSON_AddStringToObject(network, "signal", signal.c_str());
     }
     cJSON_AddItemToObject(root, "network", network);
 
@@ -1,5 +1,6 @@
 #include "power_save_timer.h"
 #include "application.h"
+#include "settings.h"
 
 #include <esp_log.h>
 
@@ -78,6 +79,8 @@ void PowerSaveTimer::PowerSaveCheck() {
         }
     }
     if (seconds_to_shutdown_ != -1 && ticks_ >= seconds_to_shutdown_ && on_shutdown_request_) {
+        // 深度睡眠和 PMIC 断电都不经过 esp_restart 的关机处理，先提交未写入的设置
+        Settings::Flush();
         on_shutdown_request_();
     }
 }
@@ -16,6 +16,12 @@
 #include <tls_transport.h>
 #include <web_socket.h>
 #include <esp_log.h>
+#include <esp_wifi.h>
+#include <esp_timer.h>
+
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
 
 #include <wifi_station.h>
 #include <wifi_configuration_ap.h>
@@ -95,9 +101,16 @@ void WifiBoard::StartNetwork() {
     wifi_station.OnConnected([this](const std::string& ssid) {
         auto display = Board::GetInstance().GetDisplay();
         std::string notification = Lang::Strings::CONNECTED_TO;
-        notification += ssid;
+        notification += ssid.empty() ? last_ap_ssid_ : ssid;
         display->ShowNotification(notification.c_str(), 30000);
     });
+    // 记录扫描、认证关联和 DHCP 的耗时，扫描和连接本身由 WifiStation 完成
+    connect_timings_ = {};
+    connect_timings_.start_us = esp_timer_get_time();
+    // WifiStation 在 Start() 中才注册事件，这里的处理函数先于它收到 WIFI_EVENT_STA_START
+    fast_connecting_ = LoadLastAp();
+    esp_event_handler_instance_register(WIFI_EVENT, ESP_EVENT_ANY_ID, &WifiBoard::OnWifiEvent, this, nullptr);
+    esp_event_handler_instance_register(IP_EVENT, IP_EVENT_STA_GOT_IP, &WifiBoard::OnWifiEvent, this, nullptr);
     wifi_station.Start();
 
     // Try to connect to WiFi, if failed, launch the WiFi configuration AP
@@ -109,6 +122,116 @@ void WifiBoard::StartNetwork() {
     }
 }
 
+bool WifiBoard::LoadLastAp() {
+    Settings settings("wifi", false);
+    auto ssid = settings.GetString("last_ssid");
+    auto bssid = settings.GetString("last_bssid");
+    int channel = settings.GetInt("last_channel");
+    if (ssid.empty() || channel <= 0) {
+        return false;
+    }
+    uint8_t* b = last_ap_bssid_;
+    if (sscanf(bssid.c_str(), "%2hhx%2hhx%2hhx%2hhx%2hhx%2hhx", &b[0], &b[1], &b[2], &b[3], &b[4], &b[5]) != 6) {
+        return false;
+    }
+    // 只连接仍在配置列表中的网络
+    auto ssid_list = SsidManager::GetInstance().GetSsidList();
+    auto it = std::find_if(ssid_list.begin(), ssid_list.end(), [&ssid](const SsidItem& item) { return item.ssid == ssid; });
+    if (it == ssid_list.end()) {
+        return false;
+    }
+    last_ap_ssid_ = it->ssid;
+    last_ap_password_ = it->password;
+    last_ap_channel_ = channel;
+    return true;
+}
+
+static void SaveLastAp(const wifi_ap_record_t& ap_info) {
+    char bssid[13];
+    snprintf(bssid, sizeof(bssid), "%02x%02x%02x%02x%02x%02x", MAC2STR(ap_info.bssid));
+    Settings settings("wifi", true);
+    settings.SetString("last_ssid", (const char*)ap_info.ssid);
+    settings.SetString("last_bssid", bssid);
+    settings.SetInt("last_channel", ap_info.primary);
+}
+
+// WifiStation 随后开始的扫描会因为正在连接而失败，连接失败后由它重连和扫描
+void WifiBoard::StartFastConnect() {
+    wifi_config_t config = {};
+    strncpy((char*)config.sta.ssid, last_ap_ssid_.c_str(), sizeof(config.sta.ssid));
+    strncpy((char*)config.sta.password, last_ap_password_.c_str(), sizeof(config.sta.password));
+    memcpy(config.sta.bssid, last_ap_bssid_, sizeof(config.sta.bssid));
+    config.sta.bssid_set = true;
+    config.sta.channel = last_ap_channel_;
+    ESP_LOGI(TAG, "Connecting to %s (bssid " MACSTR ", channel %d) without scanning",
+        last_ap_ssid_.c_str(), MAC2STR(last_ap_bssid_), last_ap_channel_);
+    if (esp_wifi_set_config(WIFI_IF_STA, &config) != ESP_OK || esp_wifi_connect() != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to start fast connect, scanning instead");
+        fast_connecting_ = false;
+    }
+}
+
+// 去掉 BSSID 和信道的限制，WifiStation 的重连会在所有信道上查找该网络，之后回到完整扫描
+void WifiBoard::StopFastConnect(int reason) {
+    ESP_LOGW(TAG, "Fast connect to %s failed, reason %d, falling back to scanning", last_ap_ssid_.c_str(), reason);
+    fast_connecting_ = false;
+    wifi_config_t config = {};
+    strncpy((char*)config.sta.ssid, last_ap_ssid_.c_str(), sizeof(config.sta.ssid));
+    strncpy((char*)config.sta.password, last_ap_password_.c_str(), sizeof(config.sta.password));
+    esp_wifi_set_config(WIFI_IF_STA, &config);
+    // 下次启动直接扫描，连接成功后重新保存
+    Settings settings("wifi", true);
+    settings.EraseKey("last_bssid");
+}
+
+// 直接连接缓存的 AP 时，WifiStation 没有通过扫描选择网络，不知道 SSID
+std::string WifiBoard::GetSsid() {
+    auto ssid = WifiStation::GetInstance().GetSsid();
+    return ssid.empty() ? last_ap_ssid_ : ssid;
+}
+
+void WifiBoard::OnWifiEvent(void* arg, esp_event_base_t event_base, int32_t event_id, void* event_data) {
+    auto board = static_cast<WifiBoard*>(arg);
+    auto& timings = board->connect_timings_;
+    auto now = esp_timer_get_time();
+    if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_START) {
+        if (board->fast_connecting_) {
+            board->StartFastConnect();
+        }
+    } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_SCAN_DONE) {
+        timings.scan_done_us = now;
+        timings.scan_count++;
+    } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_CONNECTED) {
+        timings.connected_us = now;
+    } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_DISCONNECTED) {
+        if (board->fast_connecting_) {
+            board->StopFastConnect(((wifi_event_sta_disconnected_t*)event_data)->reason);
+        }
+        if (board->has_ip_) {
+            // 断线后重新开始计时，统计恢复连接所用的时间
+            board->has_ip_ = false;
+            timings = {};
+            timings.start_us = now;
+        } else {
+            timings.retry_count++;
+        }
+    } else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP) {
+        board->has_ip_ = true;
+        // 没有扫描时（断线后直接重连）认证关联从开始计时算起
+        int64_t scan_end_us = timings.scan_count > 0 ? timings.scan_done_us : timings.start_us;
+        int64_t connected_us = timings.connected_us > 0 ? timings.connected_us : now;
+        wifi_ap_record_t ap_info = {};
+        esp_wifi_sta_get_ap_info(&ap_info);
+        ESP_LOGI(TAG, "WiFi ready in %d ms: scan %d ms (%d scans), auth/assoc %d ms (%d retries), dhcp %d ms, "
+            "bssid " MACSTR " channel %d%s",
+            (int)((now - timings.start_us) / 1000), (int)((scan_end_us - timings.start_us) / 1000), timings.scan_count,
+            (int)((connected_us - scan_end_us) / 1000), timings.retry_count, (int)((now - connected_us) / 1000),
+            MAC2STR(ap_info.bssid), ap_info.primary, board->fast_connecting_ ? ", cached AP" : "");
+        board->fast_connecting_ = false;
+        SaveLastAp(ap_info);
+    }
+}
+
 Http* WifiBoard::CreateHttp() {
     return new EspHttp();
 }
@@ -156,7 +279,7 @@ std::string WifiBoard::GetBoardJson() {
     std::string board_json = std::string("{\"type\":\"" BOARD_TYPE "\",");
     board_json += "\"name\":\"" BOARD_NAME "\",";
     if (!wifi_config_mode_) {
-        board_json += "\"ssid\":\"" + wifi_station.GetSsid() + "\",";
+        board_json += "\"ssid\":\"" + GetSsid() + "\",";
         board_json += "\"rssi\":" + std::to_string(wifi_station.GetRssi()) + ",";
         board_json += "\"channel\":" + std::to_string(wifi_station.GetChannel()) + ",";
         board_json += "\"ip\":\"" + wifi_station.GetIpAddress() + "\",";
@@ -182,6 +305,19 @@ void WifiBoard::ResetWifiConfiguration() {
     esp_restart();
 }
 
+void WifiBoard::GetNetworkStatus(std::string& type, std::string& name, std::string& signal) {
+    type = "wifi";
+    name = GetSsid();
+    int rssi = WifiStation::GetInstance().GetRssi();
+    if (rssi >= -60) {
+        signal = "strong";
+    } else if (rssi >= -70) {
+        signal = "medium";
+    } else {
+        signal = "weak";
+    }
+}
+
 std::string WifiBoard::GetDeviceStatusJson() {
     /*
      * 返回设备状态JSON
@@ -244,18 +380,12 @@ std::string WifiBoard::GetDeviceStatusJson() {
     }
 
     // Network
+    std::string type, name, signal;
+    GetNetworkStatus(type, name, signal);
     auto network = cJSON_CreateObject();
-    auto& wifi_station = WifiStation::GetInstance();
-    cJSON_AddStringToObject(network, "type", "wifi");
-    cJSON_AddStringToObject(network, "ssid", wifi_station.GetSsid().c_str());
-    int rssi = wifi_station.GetRssi();
-    if (rssi >= -60) {
-        cJSON_AddStringToObject(network, "signal", "strong");
-    } else if (rssi >= -70) {
-        cJSON_AddStringToObject(network, "signal", "medium");
-    } else {
-        cJSON_AddStringToObject(network, "signal", "weak");
-    }
+    cJSON_AddStringToObject(network, "type", type.c_str());
+    cJSON_AddStringToObject(network, "ssid", name.c_str());
+    cJSON_AddStringToObject(network, "signal", signal.c_str());
     cJSON_AddItemToObject(root, "network", network);
 
     // Chip
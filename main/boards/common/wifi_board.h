@@ -3,10 +3,36 @@
 
 #include "board.h"
 
+#include <esp_event.h>
+
 class WifiBoard : public Board {
 protected:
     bool wifi_config_mode_ = false;
     void EnterWifiConfigMode();
+
+    // 一次连接过程中各阶段完成的时间，冷启动和断线重连时重新开始计时
+    struct ConnectTimings {
+        int64_t start_us = 0;
+        int64_t scan_done_us = 0;
+        int64_t connected_us = 0;
+        int scan_count = 0;
+        int retry_count = 0;
+    };
+    ConnectTimings connect_timings_;
+    bool has_ip_ = false;
+
+    // 上次连接的 AP，启动时按 BSSID 和信道直接连接，省去扫描，失败时回到完整扫描
+    std::string last_ap_ssid_;
+    std::string last_ap_password_;
+    uint8_t last_ap_bssid_[6] = {};
+    uint8_t last_ap_channel_ = 0;
+    bool fast_connecting_ = false;
+    bool LoadLastAp();
+    void StartFastConnect();
+    void StopFastConnect(int reason);
+    std::string GetSsid();
+
+    static void OnWifiEvent(void* arg, esp_event_base_t event_base, int32_t event_id, void* event_data);
     virtual std::string GetBoardJson() override;
 
 public:
@@ -18,6 +44,7 @@ public:
     virtual Mqtt* CreateMqtt() override;
     virtual Udp* CreateUdp() override;
     virtual const char* GetNetworkStateIcon() override;
+    virtual void GetNetworkStatus(std::string& type, std::string& name, std::string& signal) override;
     virtual void SetPowerSaveMode(bool enabled) override;
     virtual void ResetWifiConfiguration();
     virtual AudioCodec* GetAudioCodec() override { return nullptr; }
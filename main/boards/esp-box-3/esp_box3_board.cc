@@ -18,6 +18,13 @@
 
 LV_FONT_DECLARE(font_puhui_20_4);
 LV_FONT_DECLARE(font_awesome_20_4);
+LV_IMAGE_DECLARE(thinking_0);
+LV_IMAGE_DECLARE(thinking_1);
+LV_IMAGE_DECLARE(thinking_2);
+LV_IMAGE_DECLARE(thinking_3);
+
+// 思考中的动画表情，帧在 thinking_animation.c 中
+static const lv_image_dsc_t* const thinking_frames[] = { &thinking_0, &thinking_1, &thinking_2, &thinking_3 };
 
 // Init ili9341 by custom cmd
 static const ili9341_lcd_init_cmd_t vendor_specific_init[] = {
@@ -141,6 +148,9 @@ private:
                                         .emoji_font = font_emoji_64_init(),
 #endif
                                     });
+        display_->SetEmotionAnimations({
+            {"thinking", thinking_frames, 4, 150, true},
+        }, 64, 64);
     }
 
     // 物联网初始化，添加对 AI 可见设备
@@ -0,0 +1,314 @@
+// "thinking" 表情动画：三个圆点依次放大跳起，64x64 RGB565，RLE 压缩
+// 由 scripts/Image_Converter/LVGLImage.py 的 RLE 压缩格式生成，背景为浅色主题的聊天区背景色 0xE0E0E0
+
+#include <lvgl.h>
+
+static const uint8_t thinking_0_map[] = {
+    0x01, 0x00, 0x00, 0x00, 0x1e, 0x04, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x7f, 0x1c, 0xe7, 0x7f,
+    0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c,
+    0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x58, 0x1c, 0xe7, 0x86, 0x7b, 0xc6,
+    0x9b, 0x9d, 0x7b, 0x8d, 0x9b, 0x9d, 0x7b, 0xc6, 0x1c, 0xe7, 0x38, 0x1c, 0xe7, 0x8a, 0x3b, 0xb6,
+    0x3b, 0x54, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0x3b, 0x54, 0x3b, 0xb6,
+    0x1c, 0xe7, 0x35, 0x1c, 0xe7, 0x8c, 0xdb, 0xa5, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0xa5, 0x1c, 0xe7, 0x33, 0x1c,
+    0xe7, 0x8e, 0x3b, 0xb6, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0x3b, 0xb6, 0x1c, 0xe7, 0x32, 0x1c,
+    0xe7, 0x8e, 0x3b, 0x54, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0x3b, 0x54, 0x1c, 0xe7, 0x31, 0x1c,
+    0xe7, 0x90, 0x7b, 0xc6, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0x7b, 0xc6,
+    0x1c, 0xe7, 0x30, 0x1c, 0xe7, 0x90, 0x9b, 0x9d, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0x9b, 0x9d, 0x1c, 0xe7, 0x30, 0x1c, 0xe7, 0xac, 0x7b, 0x8d, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0x7b, 0x8d, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x1c, 0xe7, 0xfb, 0xde, 0xf7, 0xbd, 0x34, 0xa5, 0xf3, 0x9c, 0x34, 0xa5, 0xf7, 0xbd, 0xfb, 0xde,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x1c, 0xe7, 0xfb, 0xde, 0xf7, 0xbd, 0x34, 0xa5, 0xf3, 0x9c, 0x34, 0xa5, 0xf7, 0xbd, 0xfb, 0xde,
+    0x1c, 0xe7, 0x14, 0x1c, 0xe7, 0xad, 0x9b, 0x9d, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0x9b, 0x9d, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0xfb, 0xde, 0x55, 0xad,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0x55, 0xad, 0xfb, 0xde, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0xfb, 0xde, 0x55, 0xad,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0x55, 0xad, 0xfb, 0xde, 0x1c, 0xe7,
+    0x13, 0x1c, 0xe7, 0xad, 0x7b, 0xc6, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0x7b, 0xc6, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0xf7, 0xbd, 0xf3, 0x9c, 0xf3, 0x9c,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf7, 0xbd, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0xf7, 0xbd, 0xf3, 0x9c, 0xf3, 0x9c,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf7, 0xbd, 0x1c, 0xe7, 0x14, 0x1c,
+    0xe7, 0xac, 0x3b, 0x54, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0x3b, 0x54, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x34, 0xa5, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0x34, 0xa5, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x34, 0xa5, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0x34, 0xa5, 0x1c, 0xe7, 0x14, 0x1c, 0xe7, 0xac, 0x3b, 0xb6,
+    0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0x3b, 0xb6, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x1c, 0xe7, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c,
+    0xf3, 0x9c, 0xf3, 0x9c, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x1c, 0xe7, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c,
+    0xf3, 0x9c, 0xf3, 0x9c, 0x1c, 0xe7, 0x15, 0x1c, 0xe7, 0xab, 0xdb, 0xa5, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0xa5,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x34, 0xa5, 0xf3, 0x9c,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0x34, 0xa5, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x34, 0xa5, 0xf3, 0x9c,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0x34, 0xa5, 0x1c, 0xe7,
+    0x16, 0x1c, 0xe7, 0xaa, 0x3b, 0xb6, 0x3b, 0x54, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0x3b, 0x54, 0x3b, 0xb6, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x1c, 0xe7, 0xf7, 0xbd, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf7, 0xbd, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x1c, 0xe7, 0xf7, 0xbd, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf7, 0xbd, 0x1c, 0xe7, 0x18, 0x1c, 0xe7, 0xa8, 0x7b, 0xc6, 0x9b, 0x9d,
+    0x7b, 0x8d, 0x9b, 0x9d, 0x7b, 0xc6, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0xfb, 0xde, 0x55, 0xad, 0xf3, 0x9c, 0xf3, 0x9c,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0x55, 0xad, 0xfb, 0xde, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0xfb, 0xde, 0x55, 0xad, 0xf3, 0x9c, 0xf3, 0x9c,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0x55, 0xad, 0xfb, 0xde, 0x1c, 0xe7, 0x27, 0x1c, 0xe7, 0x98,
+    0xfb, 0xde, 0xf7, 0xbd, 0x34, 0xa5, 0xf3, 0x9c, 0x34, 0xa5, 0xf7, 0xbd, 0xfb, 0xde, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7,
+    0xfb, 0xde, 0xf7, 0xbd, 0x34, 0xa5, 0xf3, 0x9c, 0x34, 0xa5, 0xf7, 0xbd, 0xfb, 0xde, 0x1c, 0xe7,
+    0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f,
+    0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c,
+    0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x58, 0x1c, 0xe7,
+};
+
+const lv_image_dsc_t thinking_0 = {
+    .header.magic = LV_IMAGE_HEADER_MAGIC,
+    .header.cf = LV_COLOR_FORMAT_RGB565,
+    .header.flags = LV_IMAGE_FLAGS_COMPRESSED,
+    .header.w = 64,
+    .header.h = 64,
+    .header.stride = 128,
+    .data_size = sizeof(thinking_0_map),
+    .data = thinking_0_map,
+};
+
+static const uint8_t thinking_1_map[] = {
+    0x01, 0x00, 0x00, 0x00, 0xf8, 0x03, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x7f, 0x1c, 0xe7, 0x7f,
+    0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c,
+    0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x68, 0x1c, 0xe7, 0x86, 0x7b, 0xc6,
+    0x9b, 0x9d, 0x7b, 0x8d, 0x9b, 0x9d, 0x7b, 0xc6, 0x1c, 0xe7, 0x38, 0x1c, 0xe7, 0x8a, 0x3b, 0xb6,
+    0x3b, 0x54, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0x3b, 0x54, 0x3b, 0xb6,
+    0x1c, 0xe7, 0x35, 0x1c, 0xe7, 0x8c, 0xdb, 0xa5, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0xa5, 0x1c, 0xe7, 0x33, 0x1c,
+    0xe7, 0x8e, 0x3b, 0xb6, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0x3b, 0xb6, 0x1c, 0xe7, 0x32, 0x1c,
+    0xe7, 0x8e, 0x3b, 0x54, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0x3b, 0x54, 0x1c, 0xe7, 0x31, 0x1c,
+    0xe7, 0x90, 0x7b, 0xc6, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0x7b, 0xc6,
+    0x1c, 0xe7, 0x30, 0x1c, 0xe7, 0x90, 0x9b, 0x9d, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0x9b, 0x9d, 0x1c, 0xe7, 0x24, 0x1c, 0xe7, 0xa8, 0xfb, 0xde, 0xf7, 0xbd, 0x34, 0xa5,
+    0xf3, 0x9c, 0x34, 0xa5, 0xf7, 0xbd, 0xfb, 0xde, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x7b, 0x8d, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0x7b, 0x8d,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0xfb, 0xde, 0xf7, 0xbd, 0x34, 0xa5,
+    0xf3, 0x9c, 0x34, 0xa5, 0xf7, 0xbd, 0xfb, 0xde, 0x1c, 0xe7, 0x17, 0x1c, 0xe7, 0xaa, 0xfb, 0xde,
+    0x55, 0xad, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0x55, 0xad, 0xfb, 0xde,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x9b, 0x9d, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0xdb, 0x3b, 0x9b, 0x9d, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0xfb, 0xde,
+    0x55, 0xad, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0x55, 0xad, 0xfb, 0xde,
+    0x1c, 0xe7, 0x16, 0x1c, 0xe7, 0xaa, 0xf7, 0xbd, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf7, 0xbd, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x7b, 0xc6, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0x7b, 0xc6, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0xf7, 0xbd, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf7, 0xbd, 0x1c, 0xe7, 0x16, 0x1c, 0xe7, 0xaa, 0x34, 0xa5,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0x34, 0xa5,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x3b, 0x54, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0x3b, 0x54, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x34, 0xa5,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0x34, 0xa5,
+    0x1c, 0xe7, 0x16, 0x1c, 0xe7, 0xaa, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x3b, 0xb6, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0x3b, 0xb6, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0x1c, 0xe7, 0x16, 0x1c, 0xe7, 0xaa, 0x34, 0xa5,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0x34, 0xa5,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0xdb, 0xa5, 0xdb, 0x3b,
+    0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0xa5, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x34, 0xa5,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0x34, 0xa5,
+    0x1c, 0xe7, 0x16, 0x1c, 0xe7, 0xaa, 0xf7, 0xbd, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf7, 0xbd, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x3b, 0xb6, 0x3b, 0x54, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0xdb, 0x3b, 0x3b, 0x54, 0x3b, 0xb6, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0xf7, 0xbd, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf7, 0xbd, 0x1c, 0xe7, 0x16, 0x1c, 0xe7, 0xaa, 0xfb, 0xde,
+    0x55, 0xad, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0x55, 0xad, 0xfb, 0xde,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x7b, 0xc6, 0x9b, 0x9d, 0x7b, 0x8d, 0x9b, 0x9d, 0x7b, 0xc6, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0xfb, 0xde,
+    0x55, 0xad, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0x55, 0xad, 0xfb, 0xde,
+    0x1c, 0xe7, 0x17, 0x1c, 0xe7, 0x88, 0xfb, 0xde, 0xf7, 0xbd, 0x34, 0xa5, 0xf3, 0x9c, 0x34, 0xa5,
+    0xf7, 0xbd, 0xfb, 0xde, 0x1c, 0xe7, 0x18, 0x1c, 0xe7, 0x88, 0xfb, 0xde, 0xf7, 0xbd, 0x34, 0xa5,
+    0xf3, 0x9c, 0x34, 0xa5, 0xf7, 0xbd, 0xfb, 0xde, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7,
+    0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f,
+    0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c,
+    0xe7, 0x58, 0x1c, 0xe7,
+};
+
+const lv_image_dsc_t thinking_1 = {
+    .header.magic = LV_IMAGE_HEADER_MAGIC,
+    .header.cf = LV_COLOR_FORMAT_RGB565,
+    .header.flags = LV_IMAGE_FLAGS_COMPRESSED,
+    .header.w = 64,
+    .header.h = 64,
+    .header.stride = 128,
+    .data_size = sizeof(thinking_1_map),
+    .data = thinking_1_map,
+};
+
+static const uint8_t thinking_2_map[] = {
+    0x01, 0x00, 0x00, 0x00, 0x1e, 0x04, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x7f, 0x1c, 0xe7, 0x7f,
+    0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c,
+    0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x78, 0x1c, 0xe7, 0x86, 0x7b, 0xc6,
+    0x9b, 0x9d, 0x7b, 0x8d, 0x9b, 0x9d, 0x7b, 0xc6, 0x1c, 0xe7, 0x38, 0x1c, 0xe7, 0x8a, 0x3b, 0xb6,
+    0x3b, 0x54, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0x3b, 0x54, 0x3b, 0xb6,
+    0x1c, 0xe7, 0x35, 0x1c, 0xe7, 0x8c, 0xdb, 0xa5, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0xa5, 0x1c, 0xe7, 0x33, 0x1c,
+    0xe7, 0x8e, 0x3b, 0xb6, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0x3b, 0xb6, 0x1c, 0xe7, 0x32, 0x1c,
+    0xe7, 0x8e, 0x3b, 0x54, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0x3b, 0x54, 0x1c, 0xe7, 0x31, 0x1c,
+    0xe7, 0x90, 0x7b, 0xc6, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0x7b, 0xc6,
+    0x1c, 0xe7, 0x30, 0x1c, 0xe7, 0x90, 0x9b, 0x9d, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0x9b, 0x9d, 0x1c, 0xe7, 0x14, 0x1c, 0xe7, 0xac, 0xfb, 0xde, 0xf7, 0xbd, 0x34, 0xa5,
+    0xf3, 0x9c, 0x34, 0xa5, 0xf7, 0xbd, 0xfb, 0xde, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0xfb, 0xde, 0xf7, 0xbd, 0x34, 0xa5,
+    0xf3, 0x9c, 0x34, 0xa5, 0xf7, 0xbd, 0xfb, 0xde, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x7b, 0x8d, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0x7b, 0x8d,
+    0x1c, 0xe7, 0x13, 0x1c, 0xe7, 0xad, 0xfb, 0xde, 0x55, 0xad, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c,
+    0xf3, 0x9c, 0xf3, 0x9c, 0x55, 0xad, 0xfb, 0xde, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0xfb, 0xde, 0x55, 0xad, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c,
+    0xf3, 0x9c, 0xf3, 0x9c, 0x55, 0xad, 0xfb, 0xde, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x9b, 0x9d, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0x9b, 0x9d, 0x1c, 0xe7,
+    0x13, 0x1c, 0xe7, 0xad, 0xf7, 0xbd, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf7, 0xbd, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x1c, 0xe7, 0xf7, 0xbd, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf7, 0xbd, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x7b, 0xc6,
+    0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0x7b, 0xc6, 0x1c, 0xe7, 0x13, 0x1c,
+    0xe7, 0xac, 0x34, 0xa5, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c,
+    0xf3, 0x9c, 0x34, 0xa5, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x34, 0xa5, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c,
+    0xf3, 0x9c, 0x34, 0xa5, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x3b, 0x54,
+    0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0x3b, 0x54, 0x1c, 0xe7, 0x14, 0x1c, 0xe7, 0xac, 0xf3, 0x9c,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0xf3, 0x9c,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x3b, 0xb6, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0x3b, 0xb6, 0x1c, 0xe7, 0x14, 0x1c, 0xe7, 0xab, 0x34, 0xa5, 0xf3, 0x9c, 0xf3, 0x9c,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0x34, 0xa5, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x34, 0xa5, 0xf3, 0x9c, 0xf3, 0x9c,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0x34, 0xa5, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0xdb, 0xa5, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0xa5, 0x1c, 0xe7,
+    0x15, 0x1c, 0xe7, 0xaa, 0xf7, 0xbd, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf7, 0xbd, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x1c, 0xe7, 0xf7, 0xbd, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf7, 0xbd, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x3b, 0xb6, 0x3b, 0x54, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b, 0xdb, 0x3b,
+    0xdb, 0x3b, 0x3b, 0x54, 0x3b, 0xb6, 0x1c, 0xe7, 0x16, 0x1c, 0xe7, 0xa8, 0xfb, 0xde, 0x55, 0xad,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0x55, 0xad, 0xfb, 0xde, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0xfb, 0xde, 0x55, 0xad,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0x55, 0xad, 0xfb, 0xde, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x7b, 0xc6, 0x9b, 0x9d, 0x7b, 0x8d, 0x9b, 0x9d, 0x7b, 0xc6, 0x1c, 0xe7, 0x19, 0x1c, 0xe7, 0x98,
+    0xfb, 0xde, 0xf7, 0xbd, 0x34, 0xa5, 0xf3, 0x9c, 0x34, 0xa5, 0xf7, 0xbd, 0xfb, 0xde, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7,
+    0xfb, 0xde, 0xf7, 0xbd, 0x34, 0xa5, 0xf3, 0x9c, 0x34, 0xa5, 0xf7, 0xbd, 0xfb, 0xde, 0x1c, 0xe7,
+    0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f,
+    0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c,
+    0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x68, 0x1c, 0xe7,
+};
+
+const lv_image_dsc_t thinking_2 = {
+    .header.magic = LV_IMAGE_HEADER_MAGIC,
+    .header.cf = LV_COLOR_FORMAT_RGB565,
+    .header.flags = LV_IMAGE_FLAGS_COMPRESSED,
+    .header.w = 64,
+    .header.h = 64,
+    .header.stride = 128,
+    .data_size = sizeof(thinking_2_map),
+    .data = thinking_2_map,
+};
+
+static const uint8_t thinking_3_map[] = {
+    0x01, 0x00, 0x00, 0x00, 0x64, 0x03, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x7f, 0x1c, 0xe7, 0x7f,
+    0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c,
+    0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7,
+    0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x1b, 0x1c, 0xe7, 0xa8, 0xfb, 0xde, 0xf7, 0xbd, 0x34, 0xa5,
+    0xf3, 0x9c, 0x34, 0xa5, 0xf7, 0xbd, 0xfb, 0xde, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0xfb, 0xde, 0xf7, 0xbd, 0x34, 0xa5,
+    0xf3, 0x9c, 0x34, 0xa5, 0xf7, 0xbd, 0xfb, 0xde, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0xfb, 0xde, 0xf7, 0xbd, 0x34, 0xa5,
+    0xf3, 0x9c, 0x34, 0xa5, 0xf7, 0xbd, 0xfb, 0xde, 0x1c, 0xe7, 0x17, 0x1c, 0xe7, 0xaa, 0xfb, 0xde,
+    0x55, 0xad, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0x55, 0xad, 0xfb, 0xde,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0xfb, 0xde,
+    0x55, 0xad, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0x55, 0xad, 0xfb, 0xde,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0xfb, 0xde,
+    0x55, 0xad, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0x55, 0xad, 0xfb, 0xde,
+    0x1c, 0xe7, 0x16, 0x1c, 0xe7, 0xaa, 0xf7, 0xbd, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf7, 0xbd, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0xf7, 0xbd, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf7, 0xbd, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0xf7, 0xbd, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf7, 0xbd, 0x1c, 0xe7, 0x16, 0x1c, 0xe7, 0xaa, 0x34, 0xa5,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0x34, 0xa5,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x34, 0xa5,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0x34, 0xa5,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x34, 0xa5,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0x34, 0xa5,
+    0x1c, 0xe7, 0x16, 0x1c, 0xe7, 0xaa, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0x1c, 0xe7, 0x16, 0x1c, 0xe7, 0xaa, 0x34, 0xa5,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0x34, 0xa5,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x34, 0xa5,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0x34, 0xa5,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x34, 0xa5,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0x34, 0xa5,
+    0x1c, 0xe7, 0x16, 0x1c, 0xe7, 0xaa, 0xf7, 0xbd, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf7, 0xbd, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0xf7, 0xbd, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf7, 0xbd, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0xf7, 0xbd, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c,
+    0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf7, 0xbd, 0x1c, 0xe7, 0x16, 0x1c, 0xe7, 0xaa, 0xfb, 0xde,
+    0x55, 0xad, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0x55, 0xad, 0xfb, 0xde,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0xfb, 0xde,
+    0x55, 0xad, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0x55, 0xad, 0xfb, 0xde,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0xfb, 0xde,
+    0x55, 0xad, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0xf3, 0x9c, 0x55, 0xad, 0xfb, 0xde,
+    0x1c, 0xe7, 0x17, 0x1c, 0xe7, 0xa8, 0xfb, 0xde, 0xf7, 0xbd, 0x34, 0xa5, 0xf3, 0x9c, 0x34, 0xa5,
+    0xf7, 0xbd, 0xfb, 0xde, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0xfb, 0xde, 0xf7, 0xbd, 0x34, 0xa5, 0xf3, 0x9c, 0x34, 0xa5,
+    0xf7, 0xbd, 0xfb, 0xde, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7,
+    0x1c, 0xe7, 0x1c, 0xe7, 0x1c, 0xe7, 0xfb, 0xde, 0xf7, 0xbd, 0x34, 0xa5, 0xf3, 0x9c, 0x34, 0xa5,
+    0xf7, 0xbd, 0xfb, 0xde, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f,
+    0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c,
+    0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x7f, 0x1c, 0xe7, 0x58, 0x1c, 0xe7,
+};
+
+const lv_image_dsc_t thinking_3 = {
+    .header.magic = LV_IMAGE_HEADER_MAGIC,
+    .header.cf = LV_COLOR_FORMAT_RGB565,
+    .header.flags = LV_IMAGE_FLAGS_COMPRESSED,
+    .header.w = 64,
+    .header.h = 64,
+    .header.stride = 128,
+    .data_size = sizeof(thinking_3_map),
+    .data = thinking_3_map,
+};
@@ -10,18 +10,48 @@
 #include "font_awesome_symbols.h"
 #include "audio_codec.h"
 #include "settings.h"
+#include "mcp_server.h"
 #include "assets/lang_config.h"
 
 #define TAG "Display"
 
+static void NotifyNetworkChanged() {
+    std::string type, name, signal;
+    Board::GetInstance().GetNetworkStatus(type, name, signal);
+    auto& mcp_server = McpServer::GetInstance();
+    mcp_server.NotifyPropertyChanged("network.type", type);
+    mcp_server.NotifyPropertyChanged(type == "wifi" ? "network.ssid" : "network.carrier", name);
+    mcp_server.NotifyPropertyChanged("network.signal", signal);
+}
+
+// 合并分组：同一分组中只保留最后一条命令，聊天消息不合并
+static int GetUiCommandGroup(UiCommandType type) {
+    switch (type) {
+    case kUiCommandStatus:
+    case kUiCommandNotification:
+        return 0;
+    case kUiCommandHideNotification:
+        return 1;
+    case kUiCommandEmotion:
+    case kUiCommandIcon:
+        return 2;
+    case kUiCommandPreviewImage:
+        return 3;
+    case kUiCommandTheme:
+        return 4;
+    case kUiCommandStatusBar:
+        return 5;
+    default:
+        return -1;
+    }
+}
+
 Display::Display() {
     // Notification timer
     esp_timer_create_args_t notification_timer_args = {
         .callback = [](void *arg) {
             Display *display = static_cast<Display*>(arg);
-            DisplayLockGuard lock(display);
-            lv_obj_add_flag(display->notification_label_, LV_OBJ_FLAG_HIDDEN);
-            lv_obj_clear_flag(display->status_label_, LV_OBJ_FLAG_HIDDEN);
+            display->PostUiCommand(UiCommand{.type = kUiCommandHideNotification});
         },
         .arg = this,
         .dispatch_method = ESP_TIMER_TASK,
@@ -44,6 +74,9 @@ Display::~Display() {
         esp_timer_stop(notification_timer_);
         esp_timer_delete(notification_timer_);
     }
+    if (ui_timer_ != nullptr) {
+        lv_timer_delete(ui_timer_);
+    }
 
     if (network_label_ != nullptr) {
         lv_obj_del(network_label_);
@@ -61,14 +94,129 @@ Display::~Display() {
     }
 }
 
-void Display::SetStatus(const char* status) {
-    DisplayLockGuard lock(this);
-    if (status_label_ == nullptr) {
+void Display::StartUiCommandTimer() {
+    std::lock_guard<std::mutex> lock(ui_mutex_);
+    if (ui_timer_ != nullptr) {
         return;
     }
-    lv_label_set_text(status_label_, status);
-    lv_obj_clear_flag(status_label_, LV_OBJ_FLAG_HIDDEN);
-    lv_obj_add_flag(notification_label_, LV_OBJ_FLAG_HIDDEN);
+    ui_timer_ = lv_timer_create([](lv_timer_t* timer) {
+        auto display = static_cast<Display*>(lv_timer_get_user_data(timer));
+        display->ApplyUiCommands();
+    }, UI_COMMAND_TIMER_PERIOD_MS, this);
+}
+
+void Display::PostUiCommand(UiCommand&& command) {
+    std::lock_guard<std::mutex> lock(ui_mutex_);
+    // 没有 UI（例如 NoDisplay）时直接丢弃
+    if (ui_timer_ == nullptr) {
+        return;
+    }
+
+    // 追加的文本直接合并到队列中最后一条聊天命令
+    if (command.type == kUiCommandChatAppend) {
+        auto it = std::find_if(ui_commands_.rbegin(), ui_commands_.rend(), [](const UiCommand& c) {
+            return c.type == kUiCommandChatMessage || c.type == kUiCommandChatAppend;
+        });
+        if (it != ui_commands_.rend()) {
+            it->text += command.text;
+            ui_stats_.coalesced++;
+            return;
+        }
+    }
+
+    int group = GetUiCommandGroup(command.type);
+    if (group >= 0) {
+        auto it = std::find_if(ui_commands_.begin(), ui_commands_.end(),
+            [group](const UiCommand& c) { return GetUiCommandGroup(c.type) == group; });
+        if (it != ui_commands_.end()) {
+            ui_commands_.erase(it);
+            ui_stats_.coalesced++;
+        }
+    } else {
+        auto count = std::count_if(ui_commands_.begin(), ui_commands_.end(),
+            [](const UiCommand& c) { return c.type == kUiCommandChatMessage; });
+        if (command.type == kUiCommandChatMessage && count >= UI_MAX_PENDING_CHAT_MESSAGES) {
+            auto it = std::find_if(ui_commands_.begin(), ui_commands_.end(),
+                [](const UiCommand& c) { return c.type == kUiCommandChatMessage; });
+            ui_commands_.erase(it);
+            ui_stats_.coalesced++;
+        }
+    }
+
+    command.post_time = esp_timer_get_time();
+    ui_commands_.push_back(std::move(command));
+    ui_stats_.max_depth = std::max(ui_stats_.max_depth, (int)ui_commands_.size());
+}
+
+// Runs in the LVGL task with the display lock held
+void Display::ApplyUiCommands() {
+    std::list<UiCommand> commands;
+    {
+        std::lock_guard<std::mutex> lock(ui_mutex_);
+        if (ui_commands_.empty()) {
+            return;
+        }
+        commands = std::move(ui_commands_);
+        ui_commands_.clear();
+    }
+
+    for (auto& command : commands) {
+        switch (command.type) {
+        case kUiCommandStatus:
+            ApplyStatus(command.text.c_str());
+            break;
+        case kUiCommandNotification:
+            ApplyNotification(command.text.c_str());
+            break;
+        case kUiCommandHideNotification:
+            ApplyHideNotification();
+            break;
+        case kUiCommandEmotion:
+            ApplyEmotion(command.text.c_str());
+            break;
+        case kUiCommandIcon:
+            ApplyIcon(command.text.c_str());
+            break;
+        case kUiCommandChatMessage:
+            PrewarmGlyphs(command.text.c_str());
+            ApplyChatMessage(command.role.c_str(), command.text.c_str());
+            break;
+        case kUiCommandChatAppend:
+            PrewarmGlyphs(command.text.c_str());
+            ApplyChatAppend(command.text.c_str());
+            break;
+        case kUiCommandPreviewImage:
+            ApplyPreviewImage(command.image);
+            break;
+        case kUiCommandTheme:
+            ApplyTheme(command.text);
+            break;
+        case kUiCommandStatusBar:
+            ApplyStatusBar();
+            break;
+        }
+    }
+
+    auto now = esp_timer_get_time();
+    std::lock_guard<std::mutex> lock(ui_mutex_);
+    for (auto& command : commands) {
+        auto latency = now - command.post_time;
+        ui_stats_.max_latency_us = std::max(ui_stats_.max_latency_us, latency);
+        ui_stats_.total_latency_us += latency;
+    }
+    ui_stats_.applied += commands.size();
+}
+
+UiQueueStats Display::GetUiQueueStats() {
+    std::lock_guard<std::mutex> lock(ui_mutex_);
+    UiQueueStats stats = ui_stats_;
+    stats.depth = ui_commands_.size();
+    ui_stats_ = UiQueueStats();
+    return stats;
+}
+
+void Display::SetStatus(const char* status) {
+    PostUiCommand(UiCommand{.type = kUiCommandStatus, .text = status});
 }
 
 void Display::ShowNotification(const std::string &notification, int duration_ms) {
@@ -76,46 +224,91 @@ void Display::ShowNotification(const std::string &notification, int duration_ms)
 }
 
 void Display::ShowNotification(const char* notification, int duration_ms) {
-    DisplayLockGuard lock(this);
-    if (notification_label_ == nullptr) {
-        return;
-    }
-    lv_label_set_text(notification_label_, notification);
-    lv_obj_clear_flag(notification_label_, LV_OBJ_FLAG_HIDDEN);
-    lv_obj_add_flag(status_label_, LV_OBJ_FLAG_HIDDEN);
+    PostUiCommand(UiCommand{.type = kUiCommandNotification, .text = notification});
 
     esp_timer_stop(notification_timer_);
     ESP_ERROR_CHECK(esp_timer_start_once(notification_timer_, duration_ms * 1000));
 }
 
-void Display::UpdateStatusBar(bool update_all) {
-    auto& board = Board::GetInstance();
-    auto codec = board.GetAudioCodec();
+void Display::SetEmotion(const char* emotion) {
+    PostUiCommand(UiCommand{.type = kUiCommandEmotion, .text = emotion});
+}
+
+void Display::SetChatMessage(const char* role, const char* content) {
+    PostUiCommand(UiCommand{.type = kUiCommandChatMessage, .role = role, .text = content != nullptr ? content : ""});
+}
 
+void Display::AppendChatMessage(const char* content) {
+    PostUiCommand(UiCommand{.type = kUiCommandChatAppend, .text = content});
+}
+
+void Display::SetIcon(const char* icon) {
+    PostUiCommand(UiCommand{.type = kUiCommandIcon, .text = icon});
+}
+
+void Display::SetPreviewImage(const lv_img_dsc_t* image) {
+    PostUiCommand(UiCommand{.type = kUiCommandPreviewImage, .image = image});
+}
+
+void Display::SetTheme(const std::string& theme_name) {
+    std::string name = theme_name;
+    for (auto& c : name) {
+        c = tolower(c);
+    }
+    if (name != "light" && name != "dark") {
+        ESP_LOGE(TAG, "Invalid theme name: %s", theme_name.c_str());
+        return;
+    }
+
+    // 在调用方更新和保存主题，GetTheme 立即返回新主题，LVGL 任务中不写 NVS
     {
-        DisplayLockGuard lock(this);
-        if (mute_label_ == nullptr) {
-            return;
-        }
+        std::lock_guard<std::mutex> lock(ui_mutex_);
+        current_theme_name_ = name;
+    }
+    Settings settings("display", true);
+    settings.SetString("theme", name);
+    McpServer::GetInstance().NotifyPropertyChanged("screen.theme", name);
 
-        // 如果静音状态改变，则更新图标
-        if (codec->output_volume() == 0 && !muted_) {
-            muted_ = true;
-            lv_label_set_text(mute_label_, FONT_AWESOME_VOLUME_MUTE);
-        } else if (codec->output_volume() > 0 && muted_) {
-            muted_ = false;
-            lv_label_set_text(mute_label_, "");
-        }
+    PostUiCommand(UiCommand{.type = kUiCommandTheme, .text = name});
+}
+
+std::string Display::GetTheme() {
+    std::lock_guard<std::mutex> lock(ui_mutex_);
+    return current_theme_name_;
+}
+
+void Display::ResetNetworkNotification() {
+    std::lock_guard<std::mutex> lock(ui_mutex_);
+    notified_network_icon_ = nullptr;
+}
+
+void Display::UpdateStatusBar(bool update_all) {
+    // 没有状态栏的显示器不需要查询电池和网络状态
+    if (mute_label_ == nullptr) {
+        return;
     }
 
+    auto& board = Board::GetInstance();
+    auto codec = board.GetAudioCodec();
+    bool changed = false;
+    bool low_battery_changed = false;
+
     esp_pm_lock_acquire(pm_lock_);
+    // 如果静音状态改变，则更新图标
+    bool muted = codec->output_volume() == 0;
+
     // 更新电池图标
     int battery_level;
     bool charging, discharging;
-    const char* icon = nullptr;
+    const char* battery_icon = nullptr;
+    bool low_battery = false;
     if (board.GetBatteryLevel(battery_level, charging, discharging)) {
+        auto& mcp_server = McpServer::GetInstance();
+        mcp_server.NotifyPropertyChanged("battery.level", battery_level);
+        mcp_server.NotifyPropertyChanged("battery.charging", charging);
+
         if (charging) {
-            icon = FONT_AWESOME_BATTERY_CHARGING;
+            battery_icon = FONT_AWESOME_BATTERY_CHARGING;
         } else {
             const char* levels[] = {
                 FONT_AWESOME_BATTERY_EMPTY, // 0-19%
@@ -125,31 +318,13 @@ void Display::UpdateStatusBar(bool update_all) {
                 FONT_AWESOME_BATTERY_FULL, // 80-99%
                 FONT_AWESOME_BATTERY_FULL, // 100%
             };
-            icon = levels[battery_level / 20];
-        }
-        DisplayLockGuard lock(this);
-        if (battery_label_ != nullptr && battery_icon_ != icon) {
-            battery_icon_ = icon;
-            lv_label_set_text(battery_label_, battery_icon_);
-        }
-
-        if (low_battery_popup_ != nullptr) {
-            if (strcmp(icon, FONT_AWESOME_BATTERY_EMPTY) == 0 && discharging) {
-                if (lv_obj_has_flag(low_battery_popup_, LV_OBJ_FLAG_HIDDEN)) { // 如果低电量提示框隐藏，则显示
-                    lv_obj_clear_flag(low_battery_popup_, LV_OBJ_FLAG_HIDDEN);
-                    auto& app = Application::GetInstance();
-                    app.PlaySound(Lang::Sounds::P3_LOW_BATTERY);
-                }
-            } else {
-                // Hide the low battery popup when the battery is not empty
-                if (!lv_obj_has_flag(low_battery_popup_, LV_OBJ_FLAG_HIDDEN)) { // 如果低电量提示框显示，则隐藏
-                    lv_obj_add_flag(low_battery_popup_, LV_OBJ_FLAG_HIDDEN);
-                }
-            }
+            battery_icon = levels[battery_level / 20];
         }
+        low_battery = strcmp(battery_icon, FONT_AWESOME_BATTERY_EMPTY) == 0 && discharging;
     }
 
     // 每 10 秒更新一次网络图标
+    const char* network_icon = nullptr;
     static int seconds_counter = 0;
     if (update_all || seconds_counter++ % 10 == 0) {
         // 升级固件时，不读取 4G 网络状态，避免占用 UART 资源
@@ -162,20 +337,109 @@ void Display::UpdateStatusBar(bool update_all) {
             kDeviceStateActivating,
         };
         if (std::find(allowed_states.begin(), allowed_states.end(), device_state) != allowed_states.end()) {
-            icon = board.GetNetworkStateIcon();
-            if (network_label_ != nullptr && icon != nullptr && network_icon_ != icon) {
-                DisplayLockGuard lock(this);
-                network_icon_ = icon;
-                lv_label_set_text(network_label_, network_icon_);
+            network_icon = board.GetNetworkStateIcon();
+            // 网络图标变化时，上报设备状态中的网络信息
+            bool network_changed = false;
+            if (network_icon != nullptr) {
+                std::lock_guard<std::mutex> lock(ui_mutex_);
+                network_changed = notified_network_icon_ != network_icon;
+                notified_network_icon_ = network_icon;
+            }
+            if (network_changed) {
+                NotifyNetworkChanged();
             }
         }
     }
-
     esp_pm_lock_release(pm_lock_);
+
+    {
+        std::lock_guard<std::mutex> lock(ui_mutex_);
+        if (muted_ != muted) {
+            muted_ = muted;
+            changed = true;
+        }
+        if (battery_icon != nullptr && battery_icon_ != battery_icon) {
+            battery_icon_ = battery_icon;
+            changed = true;
+        }
+        if (battery_icon != nullptr && low_battery_ != low_battery) {
+            low_battery_ = low_battery;
+            low_battery_changed = true;
+            changed = true;
+        }
+        if (network_icon != nullptr && network_icon_ != network_icon) {
+            network_icon_ = network_icon;
+            changed = true;
+        }
+    }
+
+    if (changed) {
+        PostUiCommand(UiCommand{.type = kUiCommandStatusBar});
+    }
+    // 低电量提示框弹出时播放提示音
+    if (low_battery_changed && low_battery && low_battery_popup_ != nullptr) {
+        Application::GetInstance().PlaySound(Lang::Sounds::P3_LOW_BATTERY);
+    }
+}
+
+void Display::ApplyStatus(const char* status) {
+    if (status_label_ == nullptr) {
+        return;
+    }
+    lv_label_set_text(status_label_, status);
+    lv_obj_clear_flag(status_label_, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_add_flag(notification_label_, LV_OBJ_FLAG_HIDDEN);
 }
 
+void Display::ApplyNotification(const char* notification) {
+    if (notification_label_ == nullptr) {
+        return;
+    }
+    lv_label_set_text(notification_label_, notification);
+    lv_obj_clear_flag(notification_label_, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_add_flag(status_label_, LV_OBJ_FLAG_HIDDEN);
+}
 
-void Display::SetEmotion(const char* emotion) {
+void Display::ApplyHideNotification() {
+    if (notification_label_ == nullptr) {
+        return;
+    }
+    lv_obj_add_flag(notification_label_, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_clear_flag(status_label_, LV_OBJ_FLAG_HIDDEN);
+}
+
+void Display::ApplyStatusBar() {
+    const char* battery_icon;
+    const char* network_icon;
+    bool muted, low_battery;
+    {
+        std::lock_guard<std::mutex> lock(ui_mutex_);
+        battery_icon = battery_icon_;
+        network_icon = network_icon_;
+        muted = muted_;
+        low_battery = low_battery_;
+    }
+
+    // 只在内容变化时设置文本，避免无谓的重绘
+    auto set_text = [](lv_obj_t* label, const char* text) {
+        if (label != nullptr && text != nullptr && strcmp(lv_label_get_text(label), text) != 0) {
+            lv_label_set_text(label, text);
+        }
+    };
+    set_text(mute_label_, muted ? FONT_AWESOME_VOLUME_MUTE : "");
+    set_text(battery_label_, battery_icon);
+    set_text(network_label_, network_icon);
+
+    if (low_battery_popup_ != nullptr) {
+        if (low_battery) {
+            lv_obj_clear_flag(low_battery_popup_, LV_OBJ_FLAG_HIDDEN);
+        } else {
+            lv_obj_add_flag(low_battery_popup_, LV_OBJ_FLAG_HIDDEN);
+        }
+    }
+}
+
+void Display::ApplyEmotion(const char* emotion) {
     struct Emotion {
         const char* icon;
         const char* text;
@@ -210,7 +474,6 @@ void Display::SetEmotion(const char* emotion) {
     auto it = std::find_if(emotions.begin(), emotions.end(),
         [&emotion_view](const Emotion& e) { return e.text == emotion_view; });
     
-    DisplayLockGuard lock(this);
     if (emotion_label_ == nullptr) {
         return;
     }
@@ -223,28 +486,28 @@ void Display::SetEmotion(const char* emotion) {
     }
 }
 
-void Display::SetIcon(const char* icon) {
-    DisplayLockGuard lock(this);
+void Display::ApplyIcon(const char* icon) {
     if (emotion_label_ == nullptr) {
         return;
     }
     lv_label_set_text(emotion_label_, icon);
 }
 
-void Display::SetPreviewImage(const lv_img_dsc_t* image) {
+void Display::ApplyPreviewImage(const lv_img_dsc_t* image) {
     // Do nothing
 }
 
-void Display::SetChatMessage(const char* role, const char* content) {
-    DisplayLockGuard lock(this);
+void Display::ApplyChatMessage(const char* role, const char* content) {
     if (chat_message_label_ == nullptr) {
         return;
     }
     lv_label_set_text(chat_message_label_, content);
 }
 
-void Display::SetTheme(const std::string& theme_name) {
-    current_theme_name_ = theme_name;
-    Settings settings("display", true);
-    settings.SetString("theme", theme_name);
+void Display::ApplyChatAppend(const char* content) {
+    if (chat_message_label_ == nullptr) {
+        return;
+    }
+    lv_label_ins_text(chat_message_label_, LV_LABEL_POS_LAST, content);
 }
+
@@ -7,6 +7,14 @@
 #include <esp_pm.h>
 
 #include <string>
+#include <list>
+#include <mutex>
+
+#include "heap_tag.h"
+
+// UI 命令队列，调用方只入队，由 LVGL 任务中的定时器统一应用，避免主循环等待显示锁
+#define UI_COMMAND_TIMER_PERIOD_MS 20
+#define UI_MAX_PENDING_CHAT_MESSAGES 10
 
 struct DisplayFonts {
     const lv_font_t* text_font = nullptr;
@@ -14,21 +22,57 @@ struct DisplayFonts {
     const lv_font_t* emoji_font = nullptr;
 };
 
+enum UiCommandType {
+    kUiCommandStatus,
+    kUiCommandNotification,
+    kUiCommandHideNotification,
+    kUiCommandEmotion,
+    kUiCommandIcon,
+    kUiCommandChatMessage,
+    kUiCommandChatAppend,
+    kUiCommandPreviewImage,
+    kUiCommandTheme,
+    kUiCommandStatusBar,
+};
+
+struct UiCommand {
+    UiCommandType type;
+    std::string role;
+    std::string text;
+    const lv_img_dsc_t* image = nullptr;
+    int64_t post_time = 0;
+};
+
+struct UiQueueStats {
+    int depth = 0;              // 当前待应用的命令数
+    int max_depth = 0;          // 统计周期内的最大队列深度
+    int applied = 0;            // 已应用的命令数
+    int coalesced = 0;          // 被后续命令合并掉的命令数
+    int64_t max_latency_us = 0; // 从入队到应用完成的最大延迟
+    int64_t total_latency_us = 0;
+};
+
 class Display {
 public:
     Display();
     virtual ~Display();
 
-    virtual void SetStatus(const char* status);
-    virtual void ShowNotification(const char* notification, int duration_ms = 3000);
-    virtual void ShowNotification(const std::string &notification, int duration_ms = 3000);
-    virtual void SetEmotion(const char* emotion);
-    virtual void SetChatMessage(const char* role, const char* content);
-    virtual void SetIcon(const char* icon);
-    virtual void SetPreviewImage(const lv_img_dsc_t* image);
-    virtual void SetTheme(const std::string& theme_name);
-    virtual std::string GetTheme() { return current_theme_name_; }
-    virtual void UpdateStatusBar(bool update_all = false);
+    // 以下接口可在任意任务中调用，不会等待显示锁
+    void SetStatus(const char* status);
+    void ShowNotification(const char* notification, int duration_ms = 3000);
+    void ShowNotification(const std::string &notification, int duration_ms = 3000);
+    void SetEmotion(const char* emotion);
+    void SetChatMessage(const char* role, const char* content);
+    // 在最新一条消息末尾追加文本，不重新设置整条消息
+    void AppendChatMessage(const char* content);
+    void SetIcon(const char* icon);
+    void SetPreviewImage(const lv_img_dsc_t* image);
+    void SetTheme(const std::string& theme_name);
+    std::string GetTheme();
+    void UpdateStatusBar(bool update_all = false);
+    // 新的 MCP 会话开始前调用，下次更新状态栏时重新上报网络状态
+    void ResetNetworkNotification();
+    UiQueueStats GetUiQueueStats();
 
     inline int width() const { return width_; }
     inline int height() const { return height_; }
@@ -50,13 +94,40 @@ protected:
     lv_obj_t* low_battery_popup_ = nullptr;
     lv_obj_t* low_battery_label_ = nullptr;
     
+    // 状态栏的目标状态，由调用方更新，ApplyStatusBar 读取
     const char* battery_icon_ = nullptr;
     const char* network_icon_ = nullptr;
+    const char* notified_network_icon_ = nullptr;
     bool muted_ = false;
+    bool low_battery_ = false;
     std::string current_theme_name_;
 
     esp_timer_handle_t notification_timer_ = nullptr;
 
+    std::mutex ui_mutex_;
+    std::list<UiCommand> ui_commands_;
+    lv_timer_t* ui_timer_ = nullptr;
+    UiQueueStats ui_stats_;
+
+    // 在 SetupUI 中调用（已持有显示锁），之后入队的命令才会被应用
+    void StartUiCommandTimer();
+    void PostUiCommand(UiCommand&& command);
+    void ApplyUiCommands();
+
+    // 以下函数只在 LVGL 任务中调用，调用时已持有显示锁
+    virtual void ApplyStatus(const char* status);
+    virtual void ApplyNotification(const char* notification);
+    virtual void ApplyHideNotification();
+    virtual void ApplyEmotion(const char* emotion);
+    virtual void ApplyChatMessage(const char* role, const char* content);
+    virtual void ApplyChatAppend(const char* content);
+    virtual void ApplyIcon(const char* icon);
+    virtual void ApplyPreviewImage(const lv_img_dsc_t* image);
+    virtual void ApplyTheme(const std::string& theme_name) {}
+    virtual void ApplyStatusBar();
+    // 在应用聊天消息之前调用，可以提前准备文本中的字形
+    virtual void PrewarmGlyphs(const char* text) {}
+
     friend class DisplayLockGuard;
     virtual bool Lock(int timeout_ms = 0) = 0;
     virtual void Unlock() = 0;
@@ -76,6 +147,8 @@ public:
 
 private:
     Display *display_;
+    // 持锁期间的分配都是 LVGL 对象
+    HeapTagScope heap_tag_scope_{kHeapTagLvgl};
 };
 
 class NoDisplay : public Display {
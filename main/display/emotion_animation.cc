@@ -0,0 +1,299 @@
+#include "emotion_animation.h"
+
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <esp_heap_caps.h>
+#include <cstring>
+#include <cassert>
+#include <algorithm>
+
+#define TAG "EmotionAnimator"
+
+// 与 LVGLImage.py 生成的压缩图片数据头一致
+struct CompressedImageHeader {
+    uint32_t method;
+    uint32_t compressed_size;
+    uint32_t decompressed_size;
+};
+#define IMAGE_COMPRESS_METHOD_RLE 1
+
+static uint8_t* AllocFrameBuffer(size_t size) {
+    auto buffer = (uint8_t*)heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (buffer == nullptr) {
+        buffer = (uint8_t*)heap_caps_malloc(size, MALLOC_CAP_8BIT);
+    }
+    return buffer;
+}
+
+// LVGL 的 RLE 格式：控制字节最高位为 1 时，后面跟着 n 个原样的像素；否则后面的 1 个像素重复 n 次
+static bool DecodeRle(const uint8_t* input, size_t input_size, uint8_t* output, size_t output_size, int block_size) {
+    const uint8_t* input_end = input + input_size;
+    uint8_t* output_end = output + output_size;
+    while (input < input_end && output < output_end) {
+        uint8_t control = *input++;
+        size_t count = control & 0x7F;
+        if (control & 0x80) {
+            size_t bytes = count * block_size;
+            if (input + bytes > input_end || output + bytes > output_end) {
+                return false;
+            }
+            memcpy(output, input, bytes);
+            input += bytes;
+            output += bytes;
+        } else {
+            if (input + block_size > input_end || output + count * block_size > output_end) {
+                return false;
+            }
+            for (size_t i = 0; i < count; i++) {
+                memcpy(output, input, block_size);
+                output += block_size;
+            }
+            input += block_size;
+        }
+    }
+    return output == output_end;
+}
+
+EmotionAnimator::EmotionAnimator(lv_obj_t* parent, int width, int height) : width_(width), height_(height) {
+    canvas_buffer_ = AllocFrameBuffer(width_ * height_ * 2);
+    assert(canvas_buffer_ != nullptr);
+    memset(canvas_buffer_, 0, width_ * height_ * 2);
+
+    canvas_ = lv_canvas_create(parent);
+    lv_canvas_set_buffer(canvas_, canvas_buffer_, width_, height_, LV_COLOR_FORMAT_RGB565);
+    lv_obj_add_flag(canvas_, LV_OBJ_FLAG_HIDDEN);
+
+    timer_ = lv_timer_create([](lv_timer_t* timer) {
+        auto self = static_cast<EmotionAnimator*>(lv_timer_get_user_data(timer));
+        self->OnTimer();
+    }, LV_DEF_REFR_PERIOD, this);
+    lv_timer_pause(timer_);
+
+    auto display = lv_obj_get_display(canvas_);
+    lv_display_add_event_cb(display, OnRefreshEvent, LV_EVENT_RENDER_START, this);
+    lv_display_add_event_cb(display, OnRefreshEvent, LV_EVENT_REFR_READY, this);
+}
+
+EmotionAnimator::~EmotionAnimator() {
+    if (canvas_ != nullptr) {
+        lv_display_remove_event_cb_with_user_data(lv_obj_get_display(canvas_), OnRefreshEvent, this);
+    }
+    if (timer_ != nullptr) {
+        lv_timer_delete(timer_);
+    }
+    if (canvas_ != nullptr) {
+        lv_obj_del(canvas_);
+    }
+    for (auto& frame : frame_cache_) {
+        heap_caps_free(frame.pixels);
+    }
+    heap_caps_free(canvas_buffer_);
+}
+
+void EmotionAnimator::AddAnimation(const EmotionAnimation& animation) {
+    if (animation.frame_count <= 0 || animation.frame_duration_ms <= 0) {
+        ESP_LOGE(TAG, "Invalid animation %s, %d frames, %d ms per frame",
+            animation.emotion, animation.frame_count, animation.frame_duration_ms);
+        return;
+    }
+    animations_.push_back(animation);
+}
+
+bool EmotionAnimator::Play(const char* emotion) {
+    auto it = std::find_if(animations_.begin(), animations_.end(),
+        [emotion](const EmotionAnimation& a) { return strcmp(a.emotion, emotion) == 0; });
+    if (it == animations_.end()) {
+        return false;
+    }
+    lv_obj_clear_flag(canvas_, LV_OBJ_FLAG_HIDDEN);
+    int index = it - animations_.begin();
+    if (animation_index_ == index) {
+        return true;
+    }
+
+    animation_index_ = index;
+    current_frame_ = -1;
+    dropped_frames_ = 0;
+    show_cost_us_ = 0;
+    render_cost_us_ = 0;
+    render_start_time_ = 0;
+    frame_pending_ = false;
+    start_time_ = esp_timer_get_time();
+    // 帧间隔不小于 LVGL 的刷新周期，否则多出来的帧也不会被绘制
+    base_interval_ms_ = std::max(it->frame_duration_ms, (int)LV_DEF_REFR_PERIOD);
+    interval_ms_ = base_interval_ms_;
+    ShowFrame(0);
+    if (it->frame_count > 1) {
+        lv_timer_set_period(timer_, interval_ms_);
+        lv_timer_resume(timer_);
+    } else {
+        lv_timer_pause(timer_);
+    }
+    return true;
+}
+
+void EmotionAnimator::Stop() {
+    if (animation_index_ < 0) {
+        return;
+    }
+    if (dropped_frames_ > 0) {
+        ESP_LOGI(TAG, "Animation %s stopped, %d frames dropped", animations_[animation_index_].emotion, dropped_frames_);
+    }
+    animation_index_ = -1;
+    lv_timer_pause(timer_);
+    lv_obj_add_flag(canvas_, LV_OBJ_FLAG_HIDDEN);
+}
+
+void EmotionAnimator::OnTimer() {
+    if (animation_index_ < 0) {
+        return;
+    }
+    auto& animation = animations_[animation_index_];
+
+    // 按时间计算应当显示的帧，来不及显示的帧直接跳过
+    auto now = esp_timer_get_time();
+    int frame = (now - start_time_) / 1000 / animation.frame_duration_ms;
+    if (frame >= animation.frame_count) {
+        if (!animation.loop) {
+            frame = animation.frame_count - 1;
+            lv_timer_pause(timer_);
+        } else {
+            frame %= animation.frame_count;
+        }
+    }
+    if (frame == current_frame_) {
+        return;
+    }
+    dropped_frames_ += (frame - current_frame_ - 1 + animation.frame_count) % animation.frame_count;
+
+    // 上一帧的总耗时：解码拷贝加上随后那次刷新的绘制时间
+    int64_t cost_us = show_cost_us_ + render_cost_us_;
+    ShowFrame(frame);
+    show_cost_us_ = esp_timer_get_time() - now;
+    render_cost_us_ = 0;
+    frame_pending_ = true;
+
+    // 超出 CPU 预算时帧间隔加倍，预算充足时逐步恢复
+    int64_t budget_us = interval_ms_ * 1000LL * EMOTION_ANIMATION_CPU_BUDGET_PERCENT / 100;
+    int interval_ms = interval_ms_;
+    if (cost_us > budget_us) {
+        interval_ms = std::min(interval_ms_ * 2, EMOTION_ANIMATION_MAX_INTERVAL_MS);
+    } else if (cost_us < budget_us / 2 && interval_ms_ > base_interval_ms_) {
+        interval_ms = std::max(interval_ms_ - base_interval_ms_, base_interval_ms_);
+    }
+    if (interval_ms != interval_ms_) {
+        ESP_LOGW(TAG, "Frame took %d us, interval %d -> %d ms, %d frames dropped",
+            (int)cost_us, interval_ms_, interval_ms, dropped_frames_);
+        interval_ms_ = interval_ms;
+        lv_timer_set_period(timer_, interval_ms_);
+    }
+}
+
+// 记录换帧后第一次刷新从开始绘制到刷新完成的时间，刷新中也包含同一时间变化的其他控件
+void EmotionAnimator::OnRefreshEvent(lv_event_t* e) {
+    auto self = static_cast<EmotionAnimator*>(lv_event_get_user_data(e));
+    if (!self->frame_pending_) {
+        return;
+    }
+    auto now = esp_timer_get_time();
+    if (lv_event_get_code(e) == LV_EVENT_RENDER_START) {
+        if (self->render_start_time_ == 0) {
+            self->render_start_time_ = now;
+        }
+    } else if (self->render_start_time_ != 0) {
+        self->render_cost_us_ = now - self->render_start_time_;
+        self->render_start_time_ = 0;
+        self->frame_pending_ = false;
+    }
+}
+
+// 返回 RGB565 像素，压缩的帧第一次使用时解码并放入缓存，缓存满时淘汰最久未使用的帧
+const uint8_t* EmotionAnimator::GetFramePixels(const lv_image_dsc_t* frame) {
+    if (!(frame->header.flags & LV_IMAGE_FLAGS_COMPRESSED)) {
+        return frame->data;
+    }
+
+    auto it = std::find_if(frame_cache_.begin(), frame_cache_.end(),
+        [frame](const CachedFrame& f) { return f.source == frame; });
+    if (it != frame_cache_.end()) {
+        frame_cache_.splice(frame_cache_.begin(), frame_cache_, it);
+        return it->pixels;
+    }
+
+    auto header = (const CompressedImageHeader*)frame->data;
+    size_t frame_size = width_ * height_ * 2;
+    if (header->method != IMAGE_COMPRESS_METHOD_RLE || header->decompressed_size != frame_size) {
+        ESP_LOGE(TAG, "Unsupported frame, method %u, size %u", (unsigned)header->method, (unsigned)header->decompressed_size);
+        return nullptr;
+    }
+
+    while (!frame_cache_.empty() && frame_cache_bytes_ + frame_size > EMOTION_FRAME_CACHE_BYTES) {
+        heap_caps_free(frame_cache_.back().pixels);
+        frame_cache_.pop_back();
+        frame_cache_bytes_ -= frame_size;
+    }
+    auto pixels = AllocFrameBuffer(frame_size);
+    if (pixels == nullptr) {
+        ESP_LOGE(TAG, "Failed to allocate frame buffer");
+        return nullptr;
+    }
+    if (!DecodeRle(frame->data + sizeof(CompressedImageHeader), header->compressed_size, pixels, frame_size, 2)) {
+        ESP_LOGE(TAG, "Failed to decode frame");
+        heap_caps_free(pixels);
+        return nullptr;
+    }
+    frame_cache_.push_front({frame, pixels});
+    frame_cache_bytes_ += frame_size;
+    return pixels;
+}
+
+// 只把与上一帧不同的部分拷贝到画布上，并只刷新这部分区域
+void EmotionAnimator::ShowFrame(int index) {
+    current_frame_ = index;
+    auto& animation = animations_[animation_index_];
+    auto frame = animation.frames[index];
+    if (frame->header.w != width_ || frame->header.h != height_ || frame->header.cf != LV_COLOR_FORMAT_RGB565) {
+        ESP_LOGE(TAG, "Frame %d of %s does not match the canvas", index, animation.emotion);
+        return;
+    }
+    auto pixels = GetFramePixels(frame);
+    if (pixels == nullptr) {
+        return;
+    }
+
+    int stride = width_ * 2;
+    int x1 = width_, y1 = height_, x2 = -1, y2 = -1;
+    for (int y = 0; y < height_; y++) {
+        auto src = (const uint16_t*)(pixels + y * stride);
+        auto dst = (uint16_t*)(canvas_buffer_ + y * stride);
+        if (memcmp(src, dst, stride) == 0) {
+            continue;
+        }
+        int left = 0;
+        while (src[left] == dst[left]) {
+            left++;
+        }
+        int right = width_ - 1;
+        while (src[right] == dst[right]) {
+            right--;
+        }
+        memcpy(dst + left, src + left, (right - left + 1) * 2);
+        x1 = std::min(x1, left);
+        x2 = std::max(x2, right);
+        y1 = std::min(y1, y);
+        y2 = y;
+    }
+    if (y2 < 0) {
+        return;
+    }
+
+    lv_area_t coords;
+    lv_obj_get_coords(canvas_, &coords);
+    lv_area_t area = {
+        .x1 = coords.x1 + x1,
+        .y1 = coords.y1 + y1,
+        .x2 = coords.x1 + x2,
+        .y2 = coords.y1 + y2,
+    };
+    lv_obj_invalidate_area(canvas_, &area);
+}
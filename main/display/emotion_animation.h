@@ -0,0 +1,74 @@
+#ifndef EMOTION_ANIMATION_H
+#define EMOTION_ANIMATION_H
+
+#include <lvgl.h>
+
+#include <list>
+#include <vector>
+#include <string>
+
+// 解码后的帧缓存上限，放在 PSRAM 中
+#define EMOTION_FRAME_CACHE_BYTES (256 * 1024)
+// 每帧解码、拷贝和 LVGL 绘制刷新的耗时占帧间隔的上限，超出时降低帧率，避免抢占音频任务的 CPU 时间
+#define EMOTION_ANIMATION_CPU_BUDGET_PERCENT 10
+#define EMOTION_ANIMATION_MAX_INTERVAL_MS 500
+
+// 一个表情动画，帧为 RGB565 格式的 lv_image_dsc_t，可以用 scripts/Image_Converter 生成 RLE 压缩的帧
+struct EmotionAnimation {
+    const char* emotion;                    // 表情名称，如 "neutral"、"thinking"
+    const lv_image_dsc_t* const* frames;
+    int frame_count;
+    int frame_duration_ms;
+    bool loop;
+};
+
+// 在 LVGL 任务中运行，所有接口都需要在持有显示锁时调用
+class EmotionAnimator {
+public:
+    EmotionAnimator(lv_obj_t* parent, int width, int height);
+    ~EmotionAnimator();
+
+    void AddAnimation(const EmotionAnimation& animation);
+    // 找不到对应的动画时返回 false
+    bool Play(const char* emotion);
+    void Stop();
+    lv_obj_t* object() const { return canvas_; }
+
+private:
+    struct CachedFrame {
+        const lv_image_dsc_t* source;
+        uint8_t* pixels;
+    };
+
+    int width_;
+    int height_;
+    lv_obj_t* canvas_ = nullptr;
+    uint8_t* canvas_buffer_ = nullptr;
+    lv_timer_t* timer_ = nullptr;
+
+    std::vector<EmotionAnimation> animations_;
+    // 正在播放的动画在 animations_ 中的序号，添加动画时 vector 可能重新分配，不能保存指针
+    int animation_index_ = -1;
+    int current_frame_ = -1;
+    int64_t start_time_ = 0;
+    int base_interval_ms_ = 0;
+    int interval_ms_ = 0;
+    int dropped_frames_ = 0;
+
+    // 上一帧解码拷贝的耗时，以及显示该帧的那次刷新的绘制耗时，下一帧时一起与预算比较
+    int64_t show_cost_us_ = 0;
+    int64_t render_cost_us_ = 0;
+    int64_t render_start_time_ = 0;
+    bool frame_pending_ = false;
+
+    // 最近使用的帧在前
+    std::list<CachedFrame> frame_cache_;
+    size_t frame_cache_bytes_ = 0;
+
+    void OnTimer();
+    static void OnRefreshEvent(lv_event_t* e);
+    const uint8_t* GetFramePixels(const lv_image_dsc_t* frame);
+    void ShowFrame(int index);
+};
+
+#endif // EMOTION_ANIMATION_H
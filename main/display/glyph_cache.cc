@@ -0,0 +1,124 @@
+#include "glyph_cache.h"
+
+#include <esp_log.h>
+#include <esp_heap_caps.h>
+#include <cstring>
+
+#define TAG "GlyphCache"
+
+GlyphCache::GlyphCache(const lv_font_t* font, size_t budget_bytes) : budget_bytes_(budget_bytes) {
+    font_ = *font;
+    get_glyph_bitmap_ = font->get_glyph_bitmap;
+    font_.get_glyph_bitmap = GetGlyphBitmap;
+    font_.user_data = this;
+    ESP_LOGI(TAG, "Glyph cache enabled, budget %u KB", (unsigned)(budget_bytes_ / 1024));
+}
+
+GlyphCache::~GlyphCache() {
+    for (auto& entry : entries_) {
+        heap_caps_free(entry.data);
+    }
+}
+
+const void* GlyphCache::GetGlyphBitmap(lv_font_glyph_dsc_t* g_dsc, lv_draw_buf_t* draw_buf) {
+    auto self = static_cast<GlyphCache*>(g_dsc->resolved_font->user_data);
+    return self->Lookup(g_dsc, draw_buf);
+}
+
+// 命中时把缓存的位图拷贝到绘制缓冲区，未命中时由原字体解码后再放入缓存
+const void* GlyphCache::Lookup(lv_font_glyph_dsc_t* g_dsc, lv_draw_buf_t* draw_buf) {
+    // 只缓存 A1~A8 格式的位图字形
+    if (g_dsc->format < LV_FONT_GLYPH_FORMAT_A1 || g_dsc->format > LV_FONT_GLYPH_FORMAT_A8 || draw_buf == nullptr) {
+        return get_glyph_bitmap_(g_dsc, draw_buf);
+    }
+
+    uint32_t glyph_id = g_dsc->gid.index;
+    auto it = index_.find(glyph_id);
+    if (it != index_.end() && it->second->size <= draw_buf->data_size) {
+        auto& entry = *it->second;
+        memcpy(draw_buf->data, entry.data, entry.size);
+        entries_.splice(entries_.begin(), entries_, it->second);
+        stats_.hits++;
+        return draw_buf->data;
+    }
+
+    stats_.misses++;
+    auto bitmap = get_glyph_bitmap_(g_dsc, draw_buf);
+    if (bitmap == nullptr || bitmap != draw_buf->data || it != index_.end()) {
+        return bitmap;
+    }
+    uint32_t size = lv_draw_buf_width_to_stride(g_dsc->box_w, LV_COLOR_FORMAT_A8) * g_dsc->box_h;
+    if (size > draw_buf->data_size) {
+        return bitmap;
+    }
+    auto data = Allocate(glyph_id, size);
+    if (data != nullptr) {
+        memcpy(data, bitmap, size);
+    }
+    return bitmap;
+}
+
+uint8_t* GlyphCache::Allocate(uint32_t glyph_id, uint32_t size) {
+    if (size == 0 || size > budget_bytes_) {
+        return nullptr;
+    }
+    while (!entries_.empty() && bytes_ + size > budget_bytes_) {
+        auto& oldest = entries_.back();
+        bytes_ -= oldest.size;
+        heap_caps_free(oldest.data);
+        index_.erase(oldest.glyph_id);
+        entries_.pop_back();
+        stats_.evictions++;
+    }
+
+    auto data = (uint8_t*)heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (data == nullptr) {
+        return nullptr;
+    }
+    entries_.push_front({glyph_id, data, size});
+    index_[glyph_id] = entries_.begin();
+    bytes_ += size;
+    return data;
+}
+
+void GlyphCache::Prewarm(const char* text) {
+    uint32_t i = 0;
+    uint32_t letter = lv_text_encoded_next(text, &i);
+    while (letter != 0) {
+        uint32_t letter_next = lv_text_encoded_next(text, &i);
+        lv_font_glyph_dsc_t g;
+        if (lv_font_get_glyph_dsc(&font_, &g, letter, letter_next) && g.resolved_font == &font_
+            && g.format >= LV_FONT_GLYPH_FORMAT_A1 && g.format <= LV_FONT_GLYPH_FORMAT_A8) {
+            auto it = index_.find(g.gid.index);
+            if (it != index_.end()) {
+                entries_.splice(entries_.begin(), entries_, it->second);
+            } else {
+                // 直接解码到缓存的内存中
+                uint32_t stride = lv_draw_buf_width_to_stride(g.box_w, LV_COLOR_FORMAT_A8);
+                uint32_t size = stride * g.box_h;
+                auto data = Allocate(g.gid.index, size);
+                if (data != nullptr) {
+                    lv_draw_buf_t draw_buf;
+                    lv_draw_buf_init(&draw_buf, g.box_w, g.box_h, LV_COLOR_FORMAT_A8, stride, data, size);
+                    if (get_glyph_bitmap_(&g, &draw_buf) != data) {
+                        bytes_ -= size;
+                        index_.erase(g.gid.index);
+                        entries_.pop_front();
+                        heap_caps_free(data);
+                    } else {
+                        stats_.prewarmed++;
+                    }
+                }
+            }
+        }
+        letter = letter_next;
+    }
+}
+
+GlyphCacheStats GlyphCache::GetStats() {
+    GlyphCacheStats stats = stats_;
+    stats.entries = entries_.size();
+    stats.bytes = bytes_;
+    stats_ = GlyphCacheStats();
+    return stats;
+}
@@ -0,0 +1,85 @@
+#ifndef GLYPH_CACHE_H
+#define GLYPH_CACHE_H
+
+#include <lvgl.h>
+#include <esp_heap_caps.h>
+
+#include <list>
+#include <new>
+#include <unordered_map>
+
+struct GlyphCacheStats {
+    int hits = 0;
+    int misses = 0;
+    int evictions = 0;
+    int prewarmed = 0;          // 预热时解码的字形数
+    int entries = 0;
+    size_t bytes = 0;
+};
+
+// 链表和哈希表的节点也分配在 PSRAM 中，否则小于 SPIRAM_MALLOC_ALWAYSINTERNAL 的节点会占用内部 RAM
+template <typename T>
+struct PsramAllocator {
+    using value_type = T;
+
+    PsramAllocator() = default;
+    template <typename U>
+    PsramAllocator(const PsramAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        auto p = heap_caps_malloc(n * sizeof(T), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (p == nullptr) {
+            p = heap_caps_malloc(n * sizeof(T), MALLOC_CAP_8BIT);
+        }
+        if (p == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(p);
+    }
+    void deallocate(T* p, size_t) { heap_caps_free(p); }
+
+    template <typename U>
+    bool operator==(const PsramAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const PsramAllocator<U>&) const { return false; }
+};
+
+// 在 PSRAM 中缓存字体解码后的 A8 字形位图，最久未使用的先淘汰
+// font() 返回原字体的副本，只替换了 get_glyph_bitmap，fallback 字体不受影响
+// 所有接口都在 LVGL 任务中调用（需持有显示锁）
+class GlyphCache {
+public:
+    GlyphCache(const lv_font_t* font, size_t budget_bytes);
+    ~GlyphCache();
+
+    const lv_font_t* font() const { return &font_; }
+    // 在设置标签文本之前调用，提前解码文本中还没有缓存的字形，避免绘制时逐个读取 flash
+    void Prewarm(const char* text);
+    // 读取后计数清零，entries 和 bytes 为当前值
+    GlyphCacheStats GetStats();
+
+private:
+    struct Entry {
+        uint32_t glyph_id;
+        uint8_t* data;
+        uint32_t size;
+    };
+
+    lv_font_t font_;
+    const void* (*get_glyph_bitmap_)(lv_font_glyph_dsc_t*, lv_draw_buf_t*);
+    size_t budget_bytes_;
+    size_t bytes_ = 0;
+    GlyphCacheStats stats_;
+
+    // 最近使用的在前
+    using EntryList = std::list<Entry, PsramAllocator<Entry>>;
+    EntryList entries_;
+    std::unordered_map<uint32_t, EntryList::iterator, std::hash<uint32_t>, std::equal_to<uint32_t>,
+        PsramAllocator<std::pair<const uint32_t, EntryList::iterator>>> index_;
+
+    static const void* GetGlyphBitmap(lv_font_glyph_dsc_t* g_dsc, lv_draw_buf_t* draw_buf);
+    const void* Lookup(lv_font_glyph_dsc_t* g_dsc, lv_draw_buf_t* draw_buf);
+    uint8_t* Allocate(uint32_t glyph_id, uint32_t size);
+};
+
+#endif // GLYPH_CACHE_H
@@ -6,14 +6,19 @@
 #include <esp_log.h>
 #include <esp_err.h>
 #include <esp_lvgl_port.h>
+#include <esp_timer.h>
+#include <esp_heap_caps.h>
 #include "assets/lang_config.h"
 #include <cstring>
 #include "settings.h"
+#include "heap_tag.h"
 
 #include "board.h"
 
 #define TAG "LcdDisplay"
 
+#define LCD_DISPLAY_STATS_INTERVAL_MS 10000
+
 // Color definitions for dark theme
 #define DARK_BACKGROUND_COLOR       lv_color_hex(0x121212)     // Dark background
 #define DARK_TEXT_COLOR             lv_color_white()           // White text
@@ -71,6 +76,14 @@ LcdDisplay::LcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_handle_
     width_ = width;
     height_ = height;
 
+#if CONFIG_GLYPH_CACHE_SIZE_KB > 0
+    // 大字库的字形解码后缓存在 PSRAM 中，之后所有使用 text_font 的地方都经过缓存
+    if (fonts_.text_font != nullptr && heap_caps_get_total_size(MALLOC_CAP_SPIRAM) > 0) {
+        glyph_cache_ = new GlyphCache(fonts_.text_font, CONFIG_GLYPH_CACHE_SIZE_KB * 1024);
+        fonts_.text_font = glyph_cache_->font();
+    }
+#endif
+
     // Load theme from settings
     Settings settings("display", false);
     current_theme_name_ = settings.GetString("theme", "light");
@@ -85,8 +98,9 @@ LcdDisplay::LcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_handle_
 
 SpiLcdDisplay::SpiLcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_handle_t panel,
                            int width, int height, int offset_x, int offset_y, bool mirror_x, bool mirror_y, bool swap_xy,
-                           DisplayFonts fonts)
+                           DisplayFonts fonts, const DisplayBufferConfig& buffer_config)
     : LcdDisplay(panel_io, panel, fonts, width, height) {
+    HeapTagScope heap_tag_scope(kHeapTagLvgl);
 
     // draw white
     std::vector<uint16_t> buffer(width_, 0xFFFF);
@@ -104,16 +118,18 @@ SpiLcdDisplay::SpiLcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_h
     ESP_LOGI(TAG, "Initialize LVGL port");
     lvgl_port_cfg_t port_cfg = ESP_LVGL_PORT_INIT_CONFIG();
     port_cfg.task_priority = 1;
-    port_cfg.timer_period_ms = 50;
+    port_cfg.timer_period_ms = buffer_config.timer_period_ms;
     lvgl_port_init(&port_cfg);
+    HeapTagger::SetTaskTag(xTaskGetHandle("taskLVGL"), kHeapTagLvgl);
 
-    ESP_LOGI(TAG, "Adding LCD screen");
+    ESP_LOGI(TAG, "Adding LCD screen, %d lines buffer, double buffer: %d, spiram: %d",
+        buffer_config.lines, buffer_config.double_buffer, buffer_config.spiram);
     const lvgl_port_display_cfg_t display_cfg = {
         .io_handle = panel_io_,
         .panel_handle = panel_,
         .control_handle = nullptr,
-        .buffer_size = static_cast<uint32_t>(width_ * 20),
-        .double_buffer = false,
+        .buffer_size = static_cast<uint32_t>(width_ * buffer_config.lines),
+        .double_buffer = buffer_config.double_buffer,
         .trans_size = 0,
         .hres = static_cast<uint32_t>(width_),
         .vres = static_cast<uint32_t>(height_),
@@ -125,8 +141,8 @@ SpiLcdDisplay::SpiLcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_h
         },
         .color_format = LV_COLOR_FORMAT_RGB565,
         .flags = {
-            .buff_dma = 1,
-            .buff_spiram = 0,
+            .buff_dma = !buffer_config.spiram,
+            .buff_spiram = buffer_config.spiram,
             .sw_rotate = 0,
             .swap_bytes = 1,
             .full_refresh = 0,
@@ -139,6 +155,7 @@ SpiLcdDisplay::SpiLcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_h
         ESP_LOGE(TAG, "Failed to add display");
         return;
     }
+    AddRefreshStatsCallback();
 
     if (offset_x != 0 || offset_y != 0) {
         lv_display_set_offset(display_, offset_x, offset_y);
@@ -151,8 +168,9 @@ SpiLcdDisplay::SpiLcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_h
 RgbLcdDisplay::RgbLcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_handle_t panel,
                            int width, int height, int offset_x, int offset_y,
                            bool mirror_x, bool mirror_y, bool swap_xy,
-                           DisplayFonts fonts)
+                           DisplayFonts fonts, const DisplayBufferConfig& buffer_config)
     : LcdDisplay(panel_io, panel, fonts, width, height) {
+    HeapTagScope heap_tag_scope(kHeapTagLvgl);
 
     // draw white
     std::vector<uint16_t> buffer(width_, 0xFFFF);
@@ -166,15 +184,17 @@ RgbLcdDisplay::RgbLcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_h
     ESP_LOGI(TAG, "Initialize LVGL port");
     lvgl_port_cfg_t port_cfg = ESP_LVGL_PORT_INIT_CONFIG();
     port_cfg.task_priority = 1;
-    port_cfg.timer_period_ms = 50;
+    port_cfg.timer_period_ms = buffer_config.timer_period_ms;
     lvgl_port_init(&port_cfg);
+    HeapTagger::SetTaskTag(xTaskGetHandle("taskLVGL"), kHeapTagLvgl);
 
-    ESP_LOGI(TAG, "Adding LCD screen");
+    ESP_LOGI(TAG, "Adding LCD screen, %d lines buffer, double buffer: %d, full frame: %d",
+        buffer_config.lines, buffer_config.double_buffer, buffer_config.full_frame);
     const lvgl_port_display_cfg_t display_cfg = {
         .io_handle = panel_io_,
         .panel_handle = panel_,
-        .buffer_size = static_cast<uint32_t>(width_ * 20),
-        .double_buffer = true,
+        .buffer_size = static_cast<uint32_t>(width_ * buffer_config.lines),
+        .double_buffer = buffer_config.double_buffer,
         .hres = static_cast<uint32_t>(width_),
         .vres = static_cast<uint32_t>(height_),
         .rotation = {
@@ -183,17 +203,19 @@ RgbLcdDisplay::RgbLcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_h
             .mirror_y = mirror_y,
         },
         .flags = {
-            .buff_dma = 1,
+            .buff_dma = !buffer_config.spiram,
+            .buff_spiram = buffer_config.spiram,
             .swap_bytes = 0,
-            .full_refresh = 1,
-            .direct_mode = 1,
+            .full_refresh = buffer_config.full_frame,
+            .direct_mode = buffer_config.full_frame,
         },
     };
 
+    // 整屏模式下直接使用 RGB 面板的帧缓冲区，可以避免撕裂
     const lvgl_port_display_rgb_cfg_t rgb_cfg = {
         .flags = {
             .bb_mode = true,
-            .avoid_tearing = true,
+            .avoid_tearing = buffer_config.full_frame,
         }
     };
     
@@ -202,6 +224,7 @@ RgbLcdDisplay::RgbLcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_h
         ESP_LOGE(TAG, "Failed to add RGB display");
         return;
     }
+    AddRefreshStatsCallback();
     
     if (offset_x != 0 || offset_y != 0) {
         lv_display_set_offset(display_, offset_x, offset_y);
@@ -213,8 +236,9 @@ RgbLcdDisplay::RgbLcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_h
 MipiLcdDisplay::MipiLcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_handle_t panel,
                             int width, int height,  int offset_x, int offset_y,
                             bool mirror_x, bool mirror_y, bool swap_xy,
-                            DisplayFonts fonts)
+                            DisplayFonts fonts, const DisplayBufferConfig& buffer_config)
     : LcdDisplay(panel_io, panel, fonts, width, height) {
+    HeapTagScope heap_tag_scope(kHeapTagLvgl);
 
     // Set the display to on
     ESP_LOGI(TAG, "Turning display on");
@@ -225,15 +249,18 @@ MipiLcdDisplay::MipiLcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel
 
     ESP_LOGI(TAG, "Initialize LVGL port");
     lvgl_port_cfg_t port_cfg = ESP_LVGL_PORT_INIT_CONFIG();
+    port_cfg.timer_period_ms = buffer_config.timer_period_ms;
     lvgl_port_init(&port_cfg);
+    HeapTagger::SetTaskTag(xTaskGetHandle("taskLVGL"), kHeapTagLvgl);
 
-    ESP_LOGI(TAG, "Adding LCD screen");
+    ESP_LOGI(TAG, "Adding LCD screen, %d lines buffer, double buffer: %d, full frame: %d",
+        buffer_config.lines, buffer_config.double_buffer, buffer_config.full_frame);
     const lvgl_port_display_cfg_t disp_cfg = {
             .io_handle = panel_io,
             .panel_handle = panel,
             .control_handle = nullptr,
-            .buffer_size = static_cast<uint32_t>(width_ * 50),
-            .double_buffer = false,
+            .buffer_size = static_cast<uint32_t>(width_ * buffer_config.lines),
+            .double_buffer = buffer_config.double_buffer,
             .hres = static_cast<uint32_t>(width_),
             .vres = static_cast<uint32_t>(height_),
             .monochrome = false,
@@ -244,15 +271,17 @@ MipiLcdDisplay::MipiLcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel
             .mirror_y = mirror_y,
         },
         .flags = {
-            .buff_dma = true,
-            .buff_spiram =false,
+            .buff_dma = !buffer_config.spiram,
+            .buff_spiram = buffer_config.spiram,
             .sw_rotate = false,
+            .full_refresh = buffer_config.full_frame,
+            .direct_mode = buffer_config.full_frame,
         },
     };
 
     const lvgl_port_display_dsi_cfg_t dpi_cfg = {
         .flags = {
-            .avoid_tearing = false,
+            .avoid_tearing = buffer_config.full_frame,
         }
     };
     display_ = lvgl_port_add_disp_dsi(&disp_cfg, &dpi_cfg);
@@ -260,6 +289,7 @@ MipiLcdDisplay::MipiLcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel
         ESP_LOGE(TAG, "Failed to add display");
         return;
     }
+    AddRefreshStatsCallback();
 
     if (offset_x != 0 || offset_y != 0) {
         lv_display_set_offset(display_, offset_x, offset_y);
@@ -269,6 +299,9 @@ MipiLcdDisplay::MipiLcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel
 }
 
 LcdDisplay::~LcdDisplay() {
+    if (emotion_animator_ != nullptr) {
+        delete emotion_animator_;
+    }
     // 然后再清理 LVGL 对象
     if (content_ != nullptr) {
         lv_obj_del(content_);
@@ -292,6 +325,70 @@ LcdDisplay::~LcdDisplay() {
     if (panel_io_ != nullptr) {
         esp_lcd_panel_io_del(panel_io_);
     }
+    // 字体副本被标签引用，最后删除
+    if (glyph_cache_ != nullptr) {
+        delete glyph_cache_;
+    }
+}
+
+void LcdDisplay::AddRefreshStatsCallback() {
+    auto callback = [](lv_event_t* e) {
+        auto self = static_cast<LcdDisplay*>(lv_event_get_user_data(e));
+        self->OnRefreshEvent(lv_event_get_code(e));
+    };
+    lv_display_add_event_cb(display_, callback, LV_EVENT_RENDER_START, this);
+    lv_display_add_event_cb(display_, callback, LV_EVENT_REFR_READY, this);
+    lv_display_add_event_cb(display_, callback, LV_EVENT_FLUSH_WAIT_START, this);
+    lv_display_add_event_cb(display_, callback, LV_EVENT_FLUSH_WAIT_FINISH, this);
+    stats_start_time_ = esp_timer_get_time();
+}
+
+// Runs in the LVGL task, the stats are printed every LCD_DISPLAY_STATS_INTERVAL_MS if anything was drawn
+void LcdDisplay::OnRefreshEvent(lv_event_code_t code) {
+    auto now = esp_timer_get_time();
+    switch (code) {
+    case LV_EVENT_RENDER_START:
+        if (render_start_time_ == 0) {
+            render_start_time_ = now;
+        }
+        break;
+    case LV_EVENT_REFR_READY:
+        // REFR_READY is sent on every timer tick, only count the ticks that rendered something
+        if (render_start_time_ != 0) {
+            frames_++;
+            render_time_us_ += now - render_start_time_;
+            render_start_time_ = 0;
+        }
+        break;
+    case LV_EVENT_FLUSH_WAIT_START:
+        flush_wait_start_time_ = now;
+        break;
+    case LV_EVENT_FLUSH_WAIT_FINISH:
+        flush_wait_time_us_ += now - flush_wait_start_time_;
+        break;
+    default:
+        break;
+    }
+
+    int64_t elapsed_us = now - stats_start_time_;
+    if (code == LV_EVENT_REFR_READY && elapsed_us >= LCD_DISPLAY_STATS_INTERVAL_MS * 1000) {
+        if (frames_ > 0) {
+            ESP_LOGI(TAG, "Refresh: %d.%d fps, %d ms per frame, %d ms waiting for flush",
+                (int)(frames_ * 1000000LL / elapsed_us), (int)(frames_ * 10000000LL / elapsed_us % 10),
+                (int)(render_time_us_ / frames_ / 1000), (int)(flush_wait_time_us_ / 1000));
+        }
+        if (glyph_cache_ != nullptr) {
+            auto stats = glyph_cache_->GetStats();
+            if (stats.hits + stats.misses > 0) {
+                ESP_LOGI(TAG, "Glyph cache: %d hits, %d misses, %d prewarmed, %d evicted, %d glyphs, %u KB",
+                    stats.hits, stats.misses, stats.prewarmed, stats.evictions, stats.entries, (unsigned)(stats.bytes / 1024));
+            }
+        }
+        stats_start_time_ = now;
+        frames_ = 0;
+        render_time_us_ = 0;
+        flush_wait_time_us_ = 0;
+    }
 }
 
 bool LcdDisplay::Lock(int timeout_ms) {
@@ -345,6 +442,10 @@ void LcdDisplay::SetupUI() {
     lv_obj_set_flex_flow(content_, LV_FLEX_FLOW_COLUMN);
     lv_obj_set_flex_align(content_, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_START);
     lv_obj_set_style_pad_row(content_, 10, 0); // Space between messages
+    lv_obj_add_event_cb(content_, [](lv_event_t* e) {
+        auto self = static_cast<LcdDisplay*>(lv_event_get_user_data(e));
+        self->UpdateVisibleChatRows();
+    }, LV_EVENT_SCROLL, this);
 
     // We'll create chat messages dynamically in SetChatMessage
     chat_message_label_ = nullptr;
@@ -411,68 +512,143 @@ void LcdDisplay::SetupUI() {
     lv_obj_set_style_text_color(low_battery_label_, lv_color_white(), 0);
     lv_obj_center(low_battery_label_);
     lv_obj_add_flag(low_battery_popup_, LV_OBJ_FLAG_HIDDEN);
+
+    StartUiCommandTimer();
 }
 #if CONFIG_IDF_TARGET_ESP32P4
 #define  MAX_MESSAGES 40
 #else
 #define  MAX_MESSAGES 20
 #endif
-void LcdDisplay::SetChatMessage(const char* role, const char* content) {
-    DisplayLockGuard lock(this);
+// 单条消息的最大字节数，超出部分截断，使气泡池的内存占用与消息长度无关
+#define  MAX_MESSAGE_BYTES 512
+
+// 在 UTF-8 字符边界处截断
+static std::string TruncateMessage(const char* content) {
+    size_t length = strlen(content);
+    if (length <= MAX_MESSAGE_BYTES) {
+        return content;
+    }
+    length = MAX_MESSAGE_BYTES;
+    while (length > 0 && (content[length] & 0xC0) == 0x80) {
+        length--;
+    }
+    return std::string(content, length) + "...";
+}
+
+// 每行是一个透明的全宽容器，内含一个气泡和一个文本标签
+lv_obj_t* LcdDisplay::CreateChatRow() {
+    lv_obj_t* row = lv_obj_create(content_);
+    lv_obj_set_width(row, LV_HOR_RES);
+    lv_obj_set_height(row, LV_SIZE_CONTENT);
+    lv_obj_set_scrollbar_mode(row, LV_SCROLLBAR_MODE_OFF);
+    lv_obj_set_style_bg_opa(row, LV_OPA_TRANSP, 0);
+    lv_obj_set_style_border_width(row, 0, 0);
+    lv_obj_set_style_pad_all(row, 0, 0);
+
+    lv_obj_t* bubble = lv_obj_create(row);
+    lv_obj_set_style_radius(bubble, 8, 0);
+    lv_obj_set_scrollbar_mode(bubble, LV_SCROLLBAR_MODE_OFF);
+    lv_obj_set_style_border_width(bubble, 1, 0);
+    lv_obj_set_style_pad_all(bubble, 8, 0);
+    lv_obj_set_width(bubble, LV_SIZE_CONTENT);
+    lv_obj_set_height(bubble, LV_SIZE_CONTENT);
+    lv_obj_set_style_flex_grow(bubble, 0, 0);
+
+    lv_obj_t* msg_text = lv_label_create(bubble);
+    lv_label_set_long_mode(msg_text, LV_LABEL_LONG_WRAP);
+    lv_obj_set_style_text_font(msg_text, fonts_.text_font, 0);
+    return row;
+}
+
+/*
+ * 只有视口上下各半屏范围内的行显示气泡并按内容计算高度。其余行固定为上次测得的高度并隐藏气泡，
+ * 滚动位置和可回滚的范围不变，但布局和绘制时跳过它们的内容。滚动时重新计算。
+ */
+void LcdDisplay::UpdateVisibleChatRows() {
+    lv_area_t viewport;
+    lv_obj_get_coords(content_, &viewport);
+    lv_coord_t margin = lv_obj_get_height(content_) / 2;
+    viewport.y1 -= margin;
+    viewport.y2 += margin;
+
+    uint32_t child_count = lv_obj_get_child_cnt(content_);
+    for (uint32_t i = 0; i < child_count; i++) {
+        lv_obj_t* row = lv_obj_get_child(content_, i);
+        lv_obj_t* bubble = lv_obj_get_child(row, 0);
+        lv_area_t area;
+        lv_obj_get_coords(row, &area);
+        bool visible = area.y2 >= viewport.y1 && area.y1 <= viewport.y2;
+        bool collapsed = lv_obj_has_flag(bubble, LV_OBJ_FLAG_HIDDEN);
+        if (visible && collapsed) {
+            lv_obj_remove_flag(bubble, LV_OBJ_FLAG_HIDDEN);
+            lv_obj_set_height(row, LV_SIZE_CONTENT);
+        } else if (!visible && !collapsed) {
+            lv_obj_set_height(row, lv_obj_get_height(row));
+            lv_obj_add_flag(bubble, LV_OBJ_FLAG_HIDDEN);
+        }
+    }
+}
+
+void LcdDisplay::StyleChatBubble(lv_obj_t* bubble, const char* role) {
+    lv_obj_t* msg_text = lv_obj_get_child(bubble, 0);
+    lv_obj_set_style_border_color(bubble, current_theme_.border, 0);
+    // 设置自定义属性标记气泡类型
+    if (strcmp(role, "user") == 0) {
+        lv_obj_set_style_bg_color(bubble, current_theme_.user_bubble, 0);
+        lv_obj_set_style_text_color(msg_text, current_theme_.text, 0);
+        lv_obj_set_user_data(bubble, (void*)"user");
+    } else if (strcmp(role, "system") == 0) {
+        lv_obj_set_style_bg_color(bubble, current_theme_.system_bubble, 0);
+        lv_obj_set_style_text_color(msg_text, current_theme_.system_text, 0);
+        lv_obj_set_user_data(bubble, (void*)"system");
+    } else {
+        lv_obj_set_style_bg_color(bubble, current_theme_.assistant_bubble, 0);
+        lv_obj_set_style_text_color(msg_text, current_theme_.text, 0);
+        lv_obj_set_user_data(bubble, (void*)"assistant");
+    }
+}
+
+void LcdDisplay::ApplyChatMessage(const char* role, const char* content) {
     if (content_ == nullptr) {
         return;
     }
     
     //避免出现空的消息框
     if(strlen(content) == 0) return;
-    
-    // 检查消息数量是否超过限制
+
+    std::string message = TruncateMessage(content);
     uint32_t child_count = lv_obj_get_child_cnt(content_);
-    if (child_count >= MAX_MESSAGES) {
-        // 删除最早的消息（第一个子对象）
-        lv_obj_t* first_child = lv_obj_get_child(content_, 0);
-        lv_obj_t* last_child = lv_obj_get_child(content_, child_count - 1);
-        if (first_child != nullptr) {
-            lv_obj_del(first_child);
-        }
-        // Scroll to the last message immediately
-        if (last_child != nullptr) {
-            lv_obj_scroll_to_view_recursive(last_child, LV_ANIM_OFF);
+    lv_obj_t* row = nullptr;
+
+    // 折叠系统消息（如果是系统消息，且最后一个消息也是系统消息，则直接复用它）
+    if (strcmp(role, "system") == 0 && child_count > 0) {
+        lv_obj_t* last_row = lv_obj_get_child(content_, child_count - 1);
+        void* bubble_type_ptr = lv_obj_get_user_data(lv_obj_get_child(last_row, 0));
+        if (bubble_type_ptr != nullptr && strcmp((const char*)bubble_type_ptr, "system") == 0) {
+            row = last_row;
         }
     }
-    
-    // 折叠系统消息（如果是系统消息，检查最后一个消息是否也是系统消息）
-    if (strcmp(role, "system") == 0 && child_count > 0) {
-        // 获取最后一个消息容器
-        lv_obj_t* last_container = lv_obj_get_child(content_, child_count - 1);
-        if (last_container != nullptr && lv_obj_get_child_cnt(last_container) > 0) {
-            // 获取容器内的气泡
-            lv_obj_t* last_bubble = lv_obj_get_child(last_container, 0);
-            if (last_bubble != nullptr) {
-                // 检查气泡类型是否为系统消息
-                void* bubble_type_ptr = lv_obj_get_user_data(last_bubble);
-                if (bubble_type_ptr != nullptr && strcmp((const char*)bubble_type_ptr, "system") == 0) {
-                    // 如果最后一个消息也是系统消息，则删除它
-                    lv_obj_del(last_container);
-                }
-            }
+
+    if (row == nullptr) {
+        if (child_count < MAX_MESSAGES) {
+            row = CreateChatRow();
+        } else {
+            // 气泡池已满，复用最早的一行并移动到末尾
+            row = lv_obj_get_child(content_, 0);
+            lv_obj_move_to_index(row, -1);
         }
     }
-    
-    // Create a message bubble
-    lv_obj_t* msg_bubble = lv_obj_create(content_);
-    lv_obj_set_style_radius(msg_bubble, 8, 0);
-    lv_obj_set_scrollbar_mode(msg_bubble, LV_SCROLLBAR_MODE_OFF);
-    lv_obj_set_style_border_width(msg_bubble, 1, 0);
-    lv_obj_set_style_border_color(msg_bubble, current_theme_.border, 0);
-    lv_obj_set_style_pad_all(msg_bubble, 8, 0);
-
-    // Create the message text
-    lv_obj_t* msg_text = lv_label_create(msg_bubble);
-    lv_label_set_text(msg_text, content);
+
+    lv_obj_t* msg_bubble = lv_obj_get_child(row, 0);
+    lv_obj_t* msg_text = lv_obj_get_child(msg_bubble, 0);
+    // 复用的行可能已被折叠，恢复为按内容计算高度
+    lv_obj_remove_flag(msg_bubble, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_set_height(row, LV_SIZE_CONTENT);
+    lv_label_set_text(msg_text, message.c_str());
     
     // 计算文本实际宽度
-    lv_coord_t text_width = lv_txt_get_width(content, strlen(content), fonts_.text_font, 0);
+    lv_coord_t text_width = lv_txt_get_width(message.c_str(), message.size(), fonts_.text_font, 0);
 
     // 计算气泡宽度
     lv_coord_t max_width = LV_HOR_RES * 85 / 100 - 16;  // 屏幕宽度的85%
@@ -492,113 +668,53 @@ void LcdDisplay::SetChatMessage(const char* role, const char* content) {
     }
     
     // 设置消息文本的宽度
-    lv_obj_set_width(msg_text, bubble_width);  // 减去padding
-    lv_label_set_long_mode(msg_text, LV_LABEL_LONG_WRAP);
-    lv_obj_set_style_text_font(msg_text, fonts_.text_font, 0);
-
-    // 设置气泡宽度
-    lv_obj_set_width(msg_bubble, bubble_width);
-    lv_obj_set_height(msg_bubble, LV_SIZE_CONTENT);
+    lv_obj_set_width(msg_text, bubble_width);
+    StyleChatBubble(msg_bubble, role);
 
-    // Set alignment and style based on message role
-    if (strcmp(role, "user") == 0) {
-        // User messages are right-aligned with green background
-        lv_obj_set_style_bg_color(msg_bubble, current_theme_.user_bubble, 0);
-        // Set text color for contrast
-        lv_obj_set_style_text_color(msg_text, current_theme_.text, 0);
-        
-        // 设置自定义属性标记气泡类型
-        lv_obj_set_user_data(msg_bubble, (void*)"user");
-        
-        // Set appropriate width for content
-        lv_obj_set_width(msg_bubble, LV_SIZE_CONTENT);
-        lv_obj_set_height(msg_bubble, LV_SIZE_CONTENT);
-        
-        // Don't grow
-        lv_obj_set_style_flex_grow(msg_bubble, 0, 0);
-    } else if (strcmp(role, "assistant") == 0) {
-        // Assistant messages are left-aligned with white background
-        lv_obj_set_style_bg_color(msg_bubble, current_theme_.assistant_bubble, 0);
-        // Set text color for contrast
-        lv_obj_set_style_text_color(msg_text, current_theme_.text, 0);
-        
-        // 设置自定义属性标记气泡类型
-        lv_obj_set_user_data(msg_bubble, (void*)"assistant");
-        
-        // Set appropriate width for content
-        lv_obj_set_width(msg_bubble, LV_SIZE_CONTENT);
-        lv_obj_set_height(msg_bubble, LV_SIZE_CONTENT);
-        
-        // Don't grow
-        lv_obj_set_style_flex_grow(msg_bubble, 0, 0);
-    } else if (strcmp(role, "system") == 0) {
-        // System messages are center-aligned with light gray background
-        lv_obj_set_style_bg_color(msg_bubble, current_theme_.system_bubble, 0);
-        // Set text color for contrast
-        lv_obj_set_style_text_color(msg_text, current_theme_.system_text, 0);
-        
-        // 设置自定义属性标记气泡类型
-        lv_obj_set_user_data(msg_bubble, (void*)"system");
-        
-        // Set appropriate width for content
-        lv_obj_set_width(msg_bubble, LV_SIZE_CONTENT);
-        lv_obj_set_height(msg_bubble, LV_SIZE_CONTENT);
-        
-        // Don't grow
-        lv_obj_set_style_flex_grow(msg_bubble, 0, 0);
-    }
-    
-    // Create a full-width container for user messages to ensure right alignment
+    // 用户消息右对齐，系统消息居中，助手消息左对齐
     if (strcmp(role, "user") == 0) {
-        // Create a full-width container
-        lv_obj_t* container = lv_obj_create(content_);
-        lv_obj_set_width(container, LV_HOR_RES);
-        lv_obj_set_height(container, LV_SIZE_CONTENT);
-        
-        // Make container transparent and borderless
-        lv_obj_set_style_bg_opa(container, LV_OPA_TRANSP, 0);
-        lv_obj_set_style_border_width(container, 0, 0);
-        lv_obj_set_style_pad_all(container, 0, 0);
-        
-        // Move the message bubble into this container
-        lv_obj_set_parent(msg_bubble, container);
-        
-        // Right align the bubble in the container
         lv_obj_align(msg_bubble, LV_ALIGN_RIGHT_MID, -25, 0);
-        
-        // Auto-scroll to this container
-        lv_obj_scroll_to_view_recursive(container, LV_ANIM_ON);
     } else if (strcmp(role, "system") == 0) {
-        // 为系统消息创建全宽容器以确保居中对齐
-        lv_obj_t* container = lv_obj_create(content_);
-        lv_obj_set_width(container, LV_HOR_RES);
-        lv_obj_set_height(container, LV_SIZE_CONTENT);
-        
-        // 使容器透明且无边框
-        lv_obj_set_style_bg_opa(container, LV_OPA_TRANSP, 0);
-        lv_obj_set_style_border_width(container, 0, 0);
-        lv_obj_set_style_pad_all(container, 0, 0);
-        
-        // 将消息气泡移入此容器
-        lv_obj_set_parent(msg_bubble, container);
-        
-        // 将气泡居中对齐在容器中
         lv_obj_align(msg_bubble, LV_ALIGN_CENTER, 0, 0);
-        
-        // 自动滚动底部
-        lv_obj_scroll_to_view_recursive(container, LV_ANIM_ON);
     } else {
-        // For assistant messages
-        // Left align assistant messages
         lv_obj_align(msg_bubble, LV_ALIGN_LEFT_MID, 0, 0);
-
-        // Auto-scroll to the message bubble
-        lv_obj_scroll_to_view_recursive(msg_bubble, LV_ANIM_ON);
     }
+
+    // 自动滚动到最新消息，行是 content_ 的直接子对象，不需要逐级滚动父对象
+    lv_obj_scroll_to_view(row, LV_ANIM_ON);
+    UpdateVisibleChatRows();
     
     // Store reference to the latest message label
     chat_message_label_ = msg_text;
 }
+
+void LcdDisplay::ApplyChatAppend(const char* content) {
+    if (chat_message_label_ == nullptr) {
+        return;
+    }
+    size_t length = strlen(lv_label_get_text(chat_message_label_));
+    if (length >= MAX_MESSAGE_BYTES) {
+        return;
+    }
+    // 只追加剩余空间能容纳的部分，同样在 UTF-8 字符边界处截断
+    size_t append_length = strlen(content);
+    if (length + append_length > MAX_MESSAGE_BYTES) {
+        append_length = MAX_MESSAGE_BYTES - length;
+        while (append_length > 0 && (content[append_length] & 0xC0) == 0x80) {
+            append_length--;
+        }
+    }
+    std::string text(content, append_length);
+    lv_label_ins_text(chat_message_label_, LV_LABEL_POS_LAST, text.c_str());
+
+    // 只按追加部分的宽度加宽气泡，不重新测量整条消息
+    lv_coord_t max_width = LV_HOR_RES * 85 / 100 - 16;
+    lv_coord_t width = lv_obj_get_style_width(chat_message_label_, 0);
+    if (width < max_width) {
+        width += lv_txt_get_width(text.c_str(), text.size(), fonts_.text_font, 0);
+        lv_obj_set_width(chat_message_label_, std::min(width, max_width));
+    }
+}
 #else
 void LcdDisplay::SetupUI() {
     DisplayLockGuard lock(this);
@@ -702,10 +818,27 @@ void LcdDisplay::SetupUI() {
     lv_obj_set_style_text_color(low_battery_label_, lv_color_white(), 0);
     lv_obj_center(low_battery_label_);
     lv_obj_add_flag(low_battery_popup_, LV_OBJ_FLAG_HIDDEN);
+
+    StartUiCommandTimer();
 }
 #endif
 
-void LcdDisplay::SetEmotion(const char* emotion) {
+void LcdDisplay::SetEmotionAnimations(const std::vector<EmotionAnimation>& animations, int width, int height) {
+    DisplayLockGuard lock(this);
+    if (emotion_label_ == nullptr) {
+        return;
+    }
+    if (emotion_animator_ == nullptr) {
+        // 动画放在 emotion_label_ 之后，由父对象的 flex 布局放在同一位置
+        emotion_animator_ = new EmotionAnimator(lv_obj_get_parent(emotion_label_), width, height);
+        lv_obj_move_to_index(emotion_animator_->object(), lv_obj_get_index(emotion_label_) + 1);
+    }
+    for (auto& animation : animations) {
+        emotion_animator_->AddAnimation(animation);
+    }
+}
+
+void LcdDisplay::ApplyEmotion(const char* emotion) {
     struct Emotion {
         const char* icon;
         const char* text;
@@ -740,11 +873,22 @@ void LcdDisplay::SetEmotion(const char* emotion) {
     auto it = std::find_if(emotions.begin(), emotions.end(),
         [&emotion_view](const Emotion& e) { return e.text == emotion_view; });
 
-    DisplayLockGuard lock(this);
     if (emotion_label_ == nullptr) {
         return;
     }
 
+    // 有对应的动画时播放动画，否则显示 emoji
+    if (emotion_animator_ != nullptr) {
+        if (emotion_animator_->Play(emotion)) {
+            lv_obj_add_flag(emotion_label_, LV_OBJ_FLAG_HIDDEN);
+            if (preview_image_ != nullptr) {
+                lv_obj_add_flag(preview_image_, LV_OBJ_FLAG_HIDDEN);
+            }
+            return;
+        }
+        emotion_animator_->Stop();
+    }
+
     // 如果找到匹配的表情就显示对应图标，否则显示默认的neutral表情
     lv_obj_set_style_text_font(emotion_label_, fonts_.emoji_font, 0);
     if (it != emotions.end()) {
@@ -760,11 +904,13 @@ void LcdDisplay::SetEmotion(const char* emotion) {
     }
 }
 
-void LcdDisplay::SetIcon(const char* icon) {
-    DisplayLockGuard lock(this);
+void LcdDisplay::ApplyIcon(const char* icon) {
     if (emotion_label_ == nullptr) {
         return;
     }
+    if (emotion_animator_ != nullptr) {
+        emotion_animator_->Stop();
+    }
     lv_obj_set_style_text_font(emotion_label_, &font_awesome_30_4, 0);
     lv_label_set_text(emotion_label_, icon);
     
@@ -775,13 +921,15 @@ void LcdDisplay::SetIcon(const char* icon) {
     }
 }
 
-void LcdDisplay::SetPreviewImage(const lv_img_dsc_t* img_dsc) {
-    DisplayLockGuard lock(this);
+void LcdDisplay::ApplyPreviewImage(const lv_img_dsc_t* img_dsc) {
     if (preview_image_ == nullptr) {
         return;
     }
     
     if (img_dsc != nullptr) {
+        if (emotion_animator_ != nullptr) {
+            emotion_animator_->Stop();
+        }
         // zoom factor 0.5
         lv_img_set_zoom(preview_image_, 128 * width_ / img_dsc->header.w);
         // 设置图片源并显示预览图片
@@ -800,12 +948,17 @@ void LcdDisplay::SetPreviewImage(const lv_img_dsc_t* img_dsc) {
     }
 }
 
-void LcdDisplay::SetTheme(const std::string& theme_name) {
-    DisplayLockGuard lock(this);
+void LcdDisplay::PrewarmGlyphs(const char* text) {
+    if (glyph_cache_ != nullptr) {
+        glyph_cache_->Prewarm(text);
+    }
+}
+
+void LcdDisplay::ApplyTheme(const std::string& theme_name) {
     
-    if (theme_name == "dark" || theme_name == "DARK") {
+    if (theme_name == "dark") {
         current_theme_ = DARK_THEME;
-    } else if (theme_name == "light" || theme_name == "LIGHT") {
+    } else if (theme_name == "light") {
         current_theme_ = LIGHT_THEME;
     } else {
         // Invalid theme name, return false
@@ -859,117 +1012,13 @@ void LcdDisplay::SetTheme(const std::string& theme_name) {
         
         // If we have the chat message style, update all message bubbles
 #if CONFIG_USE_WECHAT_MESSAGE_STYLE
-        // Iterate through all children of content (message containers or bubbles)
+        // 每行的第一个子对象是气泡，按标记的气泡类型重新设置颜色
         uint32_t child_count = lv_obj_get_child_cnt(content_);
         for (uint32_t i = 0; i < child_count; i++) {
-            lv_obj_t* obj = lv_obj_get_child(content_, i);
-            if (obj == nullptr) continue;
-            
-            lv_obj_t* bubble = nullptr;
-            
-            // 检查这个对象是容器还是气泡
-            // 如果是容器（用户或系统消息），则获取其子对象作为气泡
-            // 如果是气泡（助手消息），则直接使用
-            if (lv_obj_get_child_cnt(obj) > 0) {
-                // 可能是容器，检查它是否为用户或系统消息容器
-                // 用户和系统消息容器是透明的
-                lv_opa_t bg_opa = lv_obj_get_style_bg_opa(obj, 0);
-                if (bg_opa == LV_OPA_TRANSP) {
-                    // 这是用户或系统消息的容器
-                    bubble = lv_obj_get_child(obj, 0);
-                } else {
-                    // 这可能是助手消息的气泡自身
-                    bubble = obj;
-                }
-            } else {
-                // 没有子元素，可能是其他UI元素，跳过
-                continue;
-            }
-            
-            if (bubble == nullptr) continue;
-            
-            // 使用保存的用户数据来识别气泡类型
+            lv_obj_t* bubble = lv_obj_get_child(lv_obj_get_child(content_, i), 0);
             void* bubble_type_ptr = lv_obj_get_user_data(bubble);
             if (bubble_type_ptr != nullptr) {
-                const char* bubble_type = static_cast<const char*>(bubble_type_ptr);
-                
-                // 根据气泡类型应用正确的颜色
-                if (strcmp(bubble_type, "user") == 0) {
-                    lv_obj_set_style_bg_color(bubble, current_theme_.user_bubble, 0);
-                } else if (strcmp(bubble_type, "assistant") == 0) {
-                    lv_obj_set_style_bg_color(bubble, current_theme_.assistant_bubble, 0); 
-                } else if (strcmp(bubble_type, "system") == 0) {
-                    lv_obj_set_style_bg_color(bubble, current_theme_.system_bubble, 0);
-                }
-                
-                // Update border color
-                lv_obj_set_style_border_color(bubble, current_theme_.border, 0);
-                
-                // Update text color for the message
-                if (lv_obj_get_child_cnt(bubble) > 0) {
-                    lv_obj_t* text = lv_obj_get_child(bubble, 0);
-                    if (text != nullptr) {
-                        // 根据气泡类型设置文本颜色
-                        if (strcmp(bubble_type, "system") == 0) {
-                            lv_obj_set_style_text_color(text, current_theme_.system_text, 0);
-                        } else {
-                            lv_obj_set_style_text_color(text, current_theme_.text, 0);
-                        }
-                    }
-                }
-            } else {
-                // 如果没有标记，回退到之前的逻辑（颜色比较）
-                // ...保留原有的回退逻辑...
-                lv_color_t bg_color = lv_obj_get_style_bg_color(bubble, 0);
-            
-                // 改进bubble类型检测逻辑，不仅使用颜色比较
-                bool is_user_bubble = false;
-                bool is_assistant_bubble = false;
-                bool is_system_bubble = false;
-            
-                // 检查用户bubble
-                if (lv_color_eq(bg_color, DARK_USER_BUBBLE_COLOR) || 
-                    lv_color_eq(bg_color, LIGHT_USER_BUBBLE_COLOR) ||
-                    lv_color_eq(bg_color, current_theme_.user_bubble)) {
-                    is_user_bubble = true;
-                }
-                // 检查系统bubble
-                else if (lv_color_eq(bg_color, DARK_SYSTEM_BUBBLE_COLOR) || 
-                         lv_color_eq(bg_color, LIGHT_SYSTEM_BUBBLE_COLOR) ||
-                         lv_color_eq(bg_color, current_theme_.system_bubble)) {
-                    is_system_bubble = true;
-                }
-                // 剩余的都当作助手bubble处理
-                else {
-                    is_assistant_bubble = true;
-                }
-            
-                // 根据bubble类型应用正确的颜色
-                if (is_user_bubble) {
-                    lv_obj_set_style_bg_color(bubble, current_theme_.user_bubble, 0);
-                } else if (is_assistant_bubble) {
-                    lv_obj_set_style_bg_color(bubble, current_theme_.assistant_bubble, 0);
-                } else if (is_system_bubble) {
-                    lv_obj_set_style_bg_color(bubble, current_theme_.system_bubble, 0);
-                }
-                
-                // Update border color
-                lv_obj_set_style_border_color(bubble, current_theme_.border, 0);
-                
-                // Update text color for the message
-                if (lv_obj_get_child_cnt(bubble) > 0) {
-                    lv_obj_t* text = lv_obj_get_child(bubble, 0);
-                    if (text != nullptr) {
-                        // 回退到颜色检测逻辑
-                        if (lv_color_eq(bg_color, current_theme_.system_bubble) ||
-                            lv_color_eq(bg_color, DARK_SYSTEM_BUBBLE_COLOR) || 
-                            lv_color_eq(bg_color, LIGHT_SYSTEM_BUBBLE_COLOR)) {
-                            lv_obj_set_style_text_color(text, current_theme_.system_text, 0);
-                        } else {
-                            lv_obj_set_style_text_color(text, current_theme_.text, 0);
-                        }
-                    }
-                }
+                StyleChatBubble(bubble, static_cast<const char*>(bubble_type_ptr));
             }
         }
 #else
@@ -988,7 +1037,4 @@ void LcdDisplay::SetTheme(const std::string& theme_name) {
     if (low_battery_popup_ != nullptr) {
         lv_obj_set_style_bg_color(low_battery_popup_, current_theme_.low_battery, 0);
     }
-
-    // No errors occurred. Save theme to settings
-    Display::SetTheme(theme_name);
 }
@@ -2,6 +2,8 @@
 #define LCD_DISPLAY_H
 
 #include "display.h"
+#include "emotion_animation.h"
+#include "glyph_cache.h"
 
 #include <esp_lcd_panel_io.h>
 #include <esp_lcd_panel_ops.h>
@@ -22,6 +24,14 @@ struct ThemeColors {
     lv_color_t low_battery;
 };
 
+// LVGL 绘制缓冲区配置，各板子可根据屏幕和内存情况调整
+struct DisplayBufferConfig {
+    int lines = 20;                 // 每块绘制缓冲区的行数
+    bool double_buffer = false;     // 双缓冲，渲染下一块的同时刷新上一块
+    bool spiram = false;            // 缓冲区放在 PSRAM 中，节省内部 RAM，但不能直接用于 DMA
+    bool full_frame = false;        // 整屏缓冲区 + direct mode，仅用于 RGB / MIPI 屏幕
+    int timer_period_ms = 50;       // LVGL 定时器周期
+};
 
 class LcdDisplay : public Display {
 protected:
@@ -34,11 +44,28 @@ protected:
     lv_obj_t* container_ = nullptr;
     lv_obj_t* side_bar_ = nullptr;
     lv_obj_t* preview_image_ = nullptr;
+    EmotionAnimator* emotion_animator_ = nullptr;
+    GlyphCache* glyph_cache_ = nullptr;
 
     DisplayFonts fonts_;
     ThemeColors current_theme_;
 
+    // 刷新统计，用于根据实际帧率和刷新耗时选择缓冲区配置
+    int64_t stats_start_time_ = 0;
+    int64_t render_start_time_ = 0;
+    int64_t flush_wait_start_time_ = 0;
+    int frames_ = 0;
+    int64_t render_time_us_ = 0;
+    int64_t flush_wait_time_us_ = 0;
+
     void SetupUI();
+#if CONFIG_USE_WECHAT_MESSAGE_STYLE
+    lv_obj_t* CreateChatRow();
+    void StyleChatBubble(lv_obj_t* bubble, const char* role);
+    void UpdateVisibleChatRows();
+#endif
+    void AddRefreshStatsCallback();
+    void OnRefreshEvent(lv_event_code_t code);
     virtual bool Lock(int timeout_ms = 0) override;
     virtual void Unlock() override;
 
@@ -46,17 +73,23 @@ protected:
     // 添加protected构造函数
     LcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_handle_t panel, DisplayFonts fonts, int width, int height);
     
-public:
-    ~LcdDisplay();
-    virtual void SetEmotion(const char* emotion) override;
-    virtual void SetIcon(const char* icon) override;
-    virtual void SetPreviewImage(const lv_img_dsc_t* img_dsc) override;
+    virtual void ApplyEmotion(const char* emotion) override;
+    virtual void ApplyIcon(const char* icon) override;
+    virtual void ApplyPreviewImage(const lv_img_dsc_t* img_dsc) override;
+    virtual void PrewarmGlyphs(const char* text) override;
 #if CONFIG_USE_WECHAT_MESSAGE_STYLE
-    virtual void SetChatMessage(const char* role, const char* content) override; 
+    virtual void ApplyChatMessage(const char* role, const char* content) override; 
+    virtual void ApplyChatAppend(const char* content) override;
 #endif  
 
     // Add theme switching function
-    virtual void SetTheme(const std::string& theme_name) override;
+    virtual void ApplyTheme(const std::string& theme_name) override;
+
+public:
+    ~LcdDisplay();
+
+    // 设置动画表情，有对应动画的表情显示动画，其余仍显示 emoji 字体
+    void SetEmotionAnimations(const std::vector<EmotionAnimation>& animations, int width, int height);
 };
 
 // RGB LCD显示器
@@ -65,7 +98,8 @@ public:
     RgbLcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_handle_t panel,
                   int width, int height, int offset_x, int offset_y,
                   bool mirror_x, bool mirror_y, bool swap_xy,
-                  DisplayFonts fonts);
+                  DisplayFonts fonts,
+                  const DisplayBufferConfig& buffer_config = {.lines = 20, .double_buffer = true, .full_frame = true});
 };
 
 // MIPI LCD显示器
@@ -74,7 +108,8 @@ public:
     MipiLcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_handle_t panel,
                    int width, int height, int offset_x, int offset_y,
                    bool mirror_x, bool mirror_y, bool swap_xy,
-                   DisplayFonts fonts);
+                   DisplayFonts fonts,
+                   const DisplayBufferConfig& buffer_config = {.lines = 50, .timer_period_ms = 5});
 };
 
 // // SPI LCD显示器
@@ -83,7 +118,8 @@ public:
     SpiLcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_handle_t panel,
                   int width, int height, int offset_x, int offset_y,
                   bool mirror_x, bool mirror_y, bool swap_xy,
-                  DisplayFonts fonts);
+                  DisplayFonts fonts,
+                  const DisplayBufferConfig& buffer_config = DisplayBufferConfig());
 };
 
 // QSPI LCD显示器
@@ -92,7 +128,8 @@ public:
     QspiLcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_handle_t panel,
                    int width, int height, int offset_x, int offset_y,
                    bool mirror_x, bool mirror_y, bool swap_xy,
-                   DisplayFonts fonts);
+                   DisplayFonts fonts,
+                   const DisplayBufferConfig& buffer_config = DisplayBufferConfig());
 };
 
 // MCU8080 LCD显示器
@@ -101,6 +138,7 @@ public:
     Mcu8080LcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_handle_t panel,
                       int width, int height, int offset_x, int offset_y,
                       bool mirror_x, bool mirror_y, bool swap_xy,
-                      DisplayFonts fonts);
+                      DisplayFonts fonts,
+                      const DisplayBufferConfig& buffer_config = DisplayBufferConfig());
 };
 #endif // LCD_DISPLAY_H
@@ -1,6 +1,7 @@
 #include "oled_display.h"
 #include "font_awesome_symbols.h"
 #include "assets/lang_config.h"
+#include "heap_tag.h"
 
 #include <string>
 #include <algorithm>
@@ -8,14 +9,19 @@
 #include <esp_log.h>
 #include <esp_err.h>
 #include <esp_lvgl_port.h>
+#include <esp_timer.h>
 
 #define TAG "OledDisplay"
+// 同一页中两段变化的列之间相隔不少于该列数时分开发送，否则合并为一段
+#define OLED_FLUSH_MIN_GAP 8
+#define OLED_FLUSH_STATS_INTERVAL_MS 10000
 
 LV_FONT_DECLARE(font_awesome_30_1);
 
 OledDisplay::OledDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_handle_t panel,
     int width, int height, bool mirror_x, bool mirror_y, DisplayFonts fonts)
     : panel_io_(panel_io), panel_(panel), fonts_(fonts) {
+    HeapTagScope heap_tag_scope(kHeapTagLvgl);
     width_ = width;
     height_ = height;
 
@@ -24,6 +30,7 @@ OledDisplay::OledDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_handl
     port_cfg.task_priority = 1;
     port_cfg.timer_period_ms = 50;
     lvgl_port_init(&port_cfg);
+    HeapTagger::SetTaskTag(xTaskGetHandle("taskLVGL"), kHeapTagLvgl);
 
     ESP_LOGI(TAG, "Adding LCD screen");
     const lvgl_port_display_cfg_t display_cfg = {
@@ -56,6 +63,29 @@ OledDisplay::OledDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_handl
         return;
     }
 
+    // 替换 esp_lvgl_port 的单色刷新回调，按 8 行一页比较后只发送变化的列
+    page_buffer_.assign(width_ * ((height_ + 7) / 8), 0);
+    // 先清屏，使 page_buffer_ 与屏幕内容一致
+    esp_lcd_panel_draw_bitmap(panel_, 0, 0, width_, height_, page_buffer_.data());
+    stats_start_time_ = esp_timer_get_time();
+    if (lvgl_port_lock(0)) {
+        // driver_data 保存的是 esp_lvgl_port 的显示上下文，不能覆盖，this 存在 user_data 中
+        lv_display_set_user_data(display_, this);
+        lv_display_set_flush_cb(display_, [](lv_display_t* disp, const lv_area_t* area, uint8_t* px_map) {
+            auto self = static_cast<OledDisplay*>(lv_display_get_user_data(disp));
+            self->Flush(area, px_map);
+            lv_display_flush_ready(disp);
+        });
+        // 一次刷新可能发送零段或多段数据，由上面的回调在发送完成后通知刷新结束，
+        // 注销 esp_lvgl_port 在每段传输完成时调用 lv_display_flush_ready 的回调。
+        // OLED 使用 I2C，tx_color 在传输完成后才返回。
+        const esp_lcd_panel_io_callbacks_t callbacks = {
+            .on_color_trans_done = nullptr,
+        };
+        esp_lcd_panel_io_register_event_callbacks(panel_io_, &callbacks, nullptr);
+        lvgl_port_unlock();
+    }
+
     if (height_ == 64) {
         SetupUI_128x64();
     } else {
@@ -94,8 +124,69 @@ void OledDisplay::Unlock() {
     lvgl_port_unlock();
 }
 
-void OledDisplay::SetChatMessage(const char* role, const char* content) {
-    DisplayLockGuard lock(this);
+// Runs in the LVGL task. The I1 pixels are converted to the SSD1306 page layout in the same way as
+// esp_lvgl_port does, but only the columns that differ from page_buffer_ are sent to the panel.
+void OledDisplay::Flush(const lv_area_t* area, uint8_t* px_map) {
+    int32_t w = lv_area_get_width(area);
+    uint32_t stride = lv_draw_buf_width_to_stride(w, LV_COLOR_FORMAT_I1);
+    // 跳过 I1 格式开头 8 字节的调色板
+    const uint8_t* pixels = px_map + 8;
+
+    for (int32_t page = area->y1 / 8; page <= area->y2 / 8; page++) {
+        uint8_t* row = &page_buffer_[page * width_];
+        int32_t y_start = std::max(area->y1, page * 8);
+        int32_t y_end = std::min(area->y2, page * 8 + 7);
+        int32_t run_start = -1;
+        int32_t run_end = -1;
+
+        for (int32_t x = area->x1; x <= area->x2; x++) {
+            uint8_t value = row[x];
+            for (int32_t y = y_start; y <= y_end; y++) {
+                int32_t col = x - area->x1;
+                bool chroma_color = pixels[(y - area->y1) * stride + col / 8] & (1 << (7 - col % 8));
+                if (chroma_color) {
+                    value &= ~(1 << (y % 8));
+                } else {
+                    value |= (1 << (y % 8));
+                }
+            }
+            if (value == row[x]) {
+                continue;
+            }
+            row[x] = value;
+
+            // 与上一段相隔较远时先发送上一段
+            if (run_start >= 0 && x - run_end > OLED_FLUSH_MIN_GAP) {
+                esp_lcd_panel_draw_bitmap(panel_, run_start, page * 8, run_end + 1, page * 8 + 8, row + run_start);
+                flush_sent_bytes_ += run_end + 1 - run_start;
+                run_start = -1;
+            }
+            if (run_start < 0) {
+                run_start = x;
+            }
+            run_end = x;
+        }
+        if (run_start >= 0) {
+            esp_lcd_panel_draw_bitmap(panel_, run_start, page * 8, run_end + 1, page * 8 + 8, row + run_start);
+            flush_sent_bytes_ += run_end + 1 - run_start;
+        }
+    }
+
+    flush_count_++;
+    flush_area_bytes_ += w * (area->y2 / 8 - area->y1 / 8 + 1);
+
+    int64_t now = esp_timer_get_time();
+    if (now - stats_start_time_ >= OLED_FLUSH_STATS_INTERVAL_MS * 1000) {
+        ESP_LOGI(TAG, "Flush: %d updates, %u bytes per update, %u of %u bytes sent",
+            flush_count_, (unsigned)(flush_sent_bytes_ / flush_count_), (unsigned)flush_sent_bytes_, (unsigned)flush_area_bytes_);
+        stats_start_time_ = now;
+        flush_count_ = 0;
+        flush_area_bytes_ = 0;
+        flush_sent_bytes_ = 0;
+    }
+}
+
+void OledDisplay::ApplyChatMessage(const char* role, const char* content) {
     if (chat_message_label_ == nullptr) {
         return;
     }
@@ -116,6 +207,16 @@ void OledDisplay::SetChatMessage(const char* role, const char* content) {
     }
 }
 
+void OledDisplay::ApplyChatAppend(const char* content) {
+    if (chat_message_label_ == nullptr) {
+        return;
+    }
+
+    std::string content_str = content;
+    std::replace(content_str.begin(), content_str.end(), '\n', ' ');
+    lv_label_ins_text(chat_message_label_, LV_LABEL_POS_LAST, content_str.c_str());
+}
+
 void OledDisplay::SetupUI_128x64() {
     DisplayLockGuard lock(this);
 
@@ -223,6 +324,8 @@ void OledDisplay::SetupUI_128x64() {
     lv_obj_set_style_text_color(low_battery_label_, lv_color_white(), 0);
     lv_obj_center(low_battery_label_);
     lv_obj_add_flag(low_battery_popup_, LV_OBJ_FLAG_HIDDEN);
+
+    StartUiCommandTimer();
 }
 
 void OledDisplay::SetupUI_128x32() {
@@ -305,5 +408,7 @@ void OledDisplay::SetupUI_128x32() {
     lv_anim_set_repeat_count(&a, LV_ANIM_REPEAT_INFINITE);
     lv_obj_set_style_anim(chat_message_label_, &a, LV_PART_MAIN);
     lv_obj_set_style_anim_duration(chat_message_label_, lv_anim_speed_clamped(60, 300, 60000), LV_PART_MAIN);
+
+    StartUiCommandTimer();
 }
 
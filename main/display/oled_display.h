@@ -6,6 +6,8 @@
 #include <esp_lcd_panel_io.h>
 #include <esp_lcd_panel_ops.h>
 
+#include <vector>
+
 class OledDisplay : public Display {
 private:
     esp_lcd_panel_io_handle_t panel_io_ = nullptr;
@@ -20,18 +22,27 @@ private:
 
     DisplayFonts fonts_;
 
+    // 屏幕上当前内容的副本（SSD1306 页格式，每字节为一列中的 8 行），只发送有变化的列
+    std::vector<uint8_t> page_buffer_;
+    int64_t stats_start_time_ = 0;
+    int flush_count_ = 0;
+    size_t flush_area_bytes_ = 0;
+    size_t flush_sent_bytes_ = 0;
+
+    void Flush(const lv_area_t* area, uint8_t* px_map);
     virtual bool Lock(int timeout_ms = 0) override;
     virtual void Unlock() override;
 
     void SetupUI_128x64();
     void SetupUI_128x32();
 
+    virtual void ApplyChatMessage(const char* role, const char* content) override;
+    virtual void ApplyChatAppend(const char* content) override;
+
 public:
     OledDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_handle_t panel, int width, int height, bool mirror_x, bool mirror_y,
                 DisplayFonts fonts);
     ~OledDisplay();
-
-    virtual void SetChatMessage(const char* role, const char* content) override;
 };
 
 #endif // OLED_DISPLAY_H
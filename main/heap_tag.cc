@@ -0,0 +1,239 @@
+#include "heap_tag.h"
+
+#include <esp_attr.h>
+#include <esp_heap_caps.h>
+#include <esp_memory_utils.h>
+
+static const char* const TAG_NAMES[] = {
+    "none",
+    "lvgl",
+    "afe",
+    "opus",
+    "protocol",
+    "background_task",
+};
+
+#if CONFIG_USE_HEAP_TAGGING
+
+struct HeapTagTask {
+    TaskHandle_t task;
+    HeapTag task_tag;
+    uint8_t depth;
+    HeapTag stack[HEAP_TAG_MAX_DEPTH];
+};
+
+// 已标记的分配，按地址放在线性探测的哈希表中
+struct HeapTagEntry {
+    void* ptr;
+    uint32_t size : 24;
+    uint32_t tag : 8;
+};
+
+// 分配钩子可能在关闭 cache 时被调用，所有数据都放在内部 RAM 中
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static HeapTagTask s_tasks[HEAP_TAG_MAX_TASKS];
+static HeapTagEntry s_entries[CONFIG_HEAP_TAG_TABLE_SIZE];
+static size_t s_entry_count = 0;
+static HeapTagStats s_stats[kHeapTagCount];
+static uint32_t s_untracked_count = 0;
+
+// 以下函数调用前需持有 s_lock
+static IRAM_ATTR HeapTagTask* FindTask(TaskHandle_t task, bool create) {
+    HeapTagTask* empty = nullptr;
+    for (int i = 0; i < HEAP_TAG_MAX_TASKS; i++) {
+        if (s_tasks[i].task == task) {
+            return &s_tasks[i];
+        }
+        if (empty == nullptr && s_tasks[i].task == nullptr) {
+            empty = &s_tasks[i];
+        }
+    }
+    if (!create || empty == nullptr) {
+        return nullptr;
+    }
+    empty->task = task;
+    empty->task_tag = kHeapTagNone;
+    empty->depth = 0;
+    return empty;
+}
+
+static IRAM_ATTR void ReleaseTask(HeapTagTask* item) {
+    if (item->depth == 0 && item->task_tag == kHeapTagNone) {
+        item->task = nullptr;
+    }
+}
+
+static IRAM_ATTR HeapTag GetCurrentTag() {
+    if (xPortInIsrContext()) {
+        return kHeapTagNone;
+    }
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+    if (task == nullptr) {
+        return kHeapTagNone;
+    }
+    auto item = FindTask(task, false);
+    if (item == nullptr) {
+        return kHeapTagNone;
+    }
+    if (item->depth > 0) {
+        return item->stack[(item->depth < HEAP_TAG_MAX_DEPTH ? item->depth : HEAP_TAG_MAX_DEPTH) - 1];
+    }
+    return item->task_tag;
+}
+
+static IRAM_ATTR size_t Hash(const void* ptr) {
+    return (((uintptr_t)ptr >> 2) * 2654435761u) % CONFIG_HEAP_TAG_TABLE_SIZE;
+}
+
+static IRAM_ATTR void AddEntry(void* ptr, size_t size, HeapTag tag) {
+    // 保持装载率不超过 3/4，避免探测过长
+    if (s_entry_count >= CONFIG_HEAP_TAG_TABLE_SIZE * 3 / 4 || size >= (1 << 24)) {
+        s_untracked_count++;
+        return;
+    }
+    size_t i = Hash(ptr);
+    while (s_entries[i].ptr != nullptr) {
+        i = (i + 1) % CONFIG_HEAP_TAG_TABLE_SIZE;
+    }
+    s_entries[i].ptr = ptr;
+    s_entries[i].size = size;
+    s_entries[i].tag = tag;
+    s_entry_count++;
+
+    auto& stats = s_stats[tag];
+    stats.live_bytes += size;
+    stats.live_count++;
+    stats.alloc_count++;
+    if (stats.live_bytes > stats.peak_bytes) {
+        stats.peak_bytes = stats.live_bytes;
+    }
+}
+
+static IRAM_ATTR void RemoveEntry(void* ptr) {
+    size_t i = Hash(ptr);
+    while (s_entries[i].ptr != nullptr && s_entries[i].ptr != ptr) {
+        i = (i + 1) % CONFIG_HEAP_TAG_TABLE_SIZE;
+    }
+    if (s_entries[i].ptr == nullptr) {
+        return;
+    }
+    auto& stats = s_stats[s_entries[i].tag];
+    stats.live_bytes -= s_entries[i].size;
+    stats.live_count--;
+    s_entry_count--;
+
+    // 把之后探测链上的记录前移填补空位，查找时遇到空位即可停止
+    size_t j = i;
+    while (true) {
+        s_entries[i].ptr = nullptr;
+        while (true) {
+            j = (j + 1) % CONFIG_HEAP_TAG_TABLE_SIZE;
+            if (s_entries[j].ptr == nullptr) {
+                return;
+            }
+            size_t k = Hash(s_entries[j].ptr);
+            // 理想位置 k 在 (i, j] 之间的记录不能移到 i
+            bool in_range = i <= j ? (i < k && k <= j) : (i < k || k <= j);
+            if (!in_range) {
+                break;
+            }
+        }
+        s_entries[i] = s_entries[j];
+        i = j;
+    }
+}
+
+// heap_caps 在每次分配和释放后调用的钩子，需要 CONFIG_HEAP_USE_HOOKS
+extern "C" IRAM_ATTR void esp_heap_trace_alloc_hook(void* ptr, size_t size, uint32_t caps) {
+    if (ptr == nullptr || !esp_ptr_internal(ptr)) {
+        return;
+    }
+    portENTER_CRITICAL_SAFE(&s_lock);
+    // realloc 原地调整大小时同一地址会再次出现，先去掉旧的记录
+    RemoveEntry(ptr);
+    HeapTag tag = GetCurrentTag();
+    if (tag != kHeapTagNone) {
+        AddEntry(ptr, size, tag);
+    }
+    portEXIT_CRITICAL_SAFE(&s_lock);
+}
+
+extern "C" IRAM_ATTR void esp_heap_trace_free_hook(void* ptr) {
+    if (ptr == nullptr || !esp_ptr_internal(ptr)) {
+        return;
+    }
+    portENTER_CRITICAL_SAFE(&s_lock);
+    RemoveEntry(ptr);
+    portEXIT_CRITICAL_SAFE(&s_lock);
+}
+
+void HeapTagger::SetTaskTag(TaskHandle_t task, HeapTag tag) {
+    if (task == nullptr) {
+        return;
+    }
+    portENTER_CRITICAL(&s_lock);
+    auto item = FindTask(task, tag != kHeapTagNone);
+    if (item != nullptr) {
+        item->task_tag = tag;
+        ReleaseTask(item);
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void HeapTagger::Push(HeapTag tag) {
+    portENTER_CRITICAL(&s_lock);
+    auto item = FindTask(xTaskGetCurrentTaskHandle(), true);
+    if (item != nullptr) {
+        if (item->depth < HEAP_TAG_MAX_DEPTH) {
+            item->stack[item->depth] = tag;
+        }
+        item->depth++;
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void HeapTagger::Pop() {
+    portENTER_CRITICAL(&s_lock);
+    auto item = FindTask(xTaskGetCurrentTaskHandle(), false);
+    if (item != nullptr && item->depth > 0) {
+        item->depth--;
+        ReleaseTask(item);
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+HeapTagStats HeapTagger::GetStats(HeapTag tag) {
+    portENTER_CRITICAL(&s_lock);
+    HeapTagStats stats = s_stats[tag];
+    portEXIT_CRITICAL(&s_lock);
+    return stats;
+}
+
+uint32_t HeapTagger::GetUntrackedCount() {
+    return s_untracked_count;
+}
+
+#else
+
+void HeapTagger::SetTaskTag(TaskHandle_t task, HeapTag tag) {
+}
+
+void HeapTagger::Push(HeapTag tag) {
+}
+
+void HeapTagger::Pop() {
+}
+
+HeapTagStats HeapTagger::GetStats(HeapTag tag) {
+    return {};
+}
+
+uint32_t HeapTagger::GetUntrackedCount() {
+    return 0;
+}
+
+#endif // CONFIG_USE_HEAP_TAGGING
+
+const char* HeapTagger::GetName(HeapTag tag) {
+    return tag < kHeapTagCount ? TAG_NAMES[tag] : "unknown";
+}
@@ -0,0 +1,59 @@
+#ifndef _HEAP_TAG_H_
+#define _HEAP_TAG_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// 可以同时设置标签的任务数，以及每个任务中标签作用域的最大嵌套层数
+#define HEAP_TAG_MAX_TASKS 16
+#define HEAP_TAG_MAX_DEPTH 4
+
+enum HeapTag : uint8_t {
+    kHeapTagNone,
+    kHeapTagLvgl,
+    kHeapTagAfe,
+    kHeapTagOpus,
+    kHeapTagProtocol,
+    kHeapTagBackgroundTask,
+    kHeapTagCount
+};
+
+struct HeapTagStats {
+    size_t live_bytes;
+    size_t peak_bytes;
+    uint32_t live_count;
+    uint32_t alloc_count;       // 累计分配次数
+};
+
+// 按子系统统计内部 RAM 的分配：任务进入某个子系统时设置标签，
+// heap_caps 的分配钩子把这期间的分配记到该标签下，释放时从对应的标签中扣除
+class HeapTagger {
+public:
+    // 任务没有进入任何作用域时使用的标签
+    static void SetTaskTag(TaskHandle_t task, HeapTag tag);
+    static void Push(HeapTag tag);
+    static void Pop();
+
+    static HeapTagStats GetStats(HeapTag tag);
+    // 分配记录表已满而没有统计到的分配次数
+    static uint32_t GetUntrackedCount();
+    static const char* GetName(HeapTag tag);
+};
+
+// 作用域内当前任务的内部 RAM 分配都记到 tag 下
+class HeapTagScope {
+public:
+#if CONFIG_USE_HEAP_TAGGING
+    explicit HeapTagScope(HeapTag tag) { HeapTagger::Push(tag); }
+    ~HeapTagScope() { HeapTagger::Pop(); }
+#else
+    explicit HeapTagScope(HeapTag tag) {}
+#endif
+    HeapTagScope(const HeapTagScope&) = delete;
+    HeapTagScope& operator=(const HeapTagScope&) = delete;
+};
+
+#endif // _HEAP_TAG_H_
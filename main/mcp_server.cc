@@ -12,13 +12,36 @@
 #include "application.h"
 #include "display.h"
 #include "board.h"
+#include "telemetry.h"
 
 #define TAG "MCP"
 
 McpServer::McpServer() {
+    esp_timer_create_args_t timer_args = {
+        .callback = [](void* arg) {
+            McpServer* server = (McpServer*)arg;
+            server->SendPropertyChanges();
+        },
+        .arg = this,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "mcp_notify",
+        .skip_unhandled_events = true
+    };
+    esp_timer_create(&timer_args, &notify_timer_);
 }
 
 McpServer::~McpServer() {
+    if (notify_timer_ != nullptr) {
+        esp_timer_stop(notify_timer_);
+        esp_timer_delete(notify_timer_);
+    }
+    if (tool_timeout_timer_ != nullptr) {
+        esp_timer_stop(tool_timeout_timer_);
+        esp_timer_delete(tool_timeout_timer_);
+    }
+    for (auto worker : tool_workers_) {
+        vTaskDelete(worker);
+    }
     for (auto tool : tools_) {
         delete tool;
     }
@@ -92,31 +115,82 @@ void McpServer::AddCommonTools() {
                 Property("question", kPropertyTypeString)
             }),
             [camera](const PropertyList& properties) -> ReturnValue {
-                if (!camera->Capture()) {
-                    return "{\"success\": false, \"message\": \"Failed to capture photo\"}";
-                }
                 auto question = properties["question"].value<std::string>();
-                return camera->Explain(question);
+                return camera->CaptureAndExplain(question);
+            },
+            // 拍照、编码和上传耗时较长，放到工具线程中执行，避免阻塞主循环
+            kToolExecutionAsync, 1, 60000);
+
+        AddTool("self.camera.start_watching",
+            "Keep watching with the camera at a low frame rate. When the scene changes noticeably, a photo is taken and explained "
+            "automatically, and the result is sent with `notifications/camera_scene_changed`. Use this tool when the user asks you "
+            "to keep an eye on something.\n"
+            "Args:\n"
+            "  `interval`: Seconds between two checks.\n"
+            "  `threshold`: How much the scene must change to trigger, 1 is very sensitive and 100 is very insensitive.\n"
+            "  `question`: The question to ask about the changed scene.",
+            PropertyList({
+                Property("interval", kPropertyTypeInteger, 3, 1, 60),
+                Property("threshold", kPropertyTypeInteger, 12, 1, 100),
+                Property("question", kPropertyTypeString)
+            }),
+            [camera](const PropertyList& properties) -> ReturnValue {
+                return camera->StartWatching(properties["interval"].value<int>() * 1000,
+                    properties["threshold"].value<int>(), properties["question"].value<std::string>());
+            });
+
+        AddTool("self.camera.stop_watching",
+            "Stop watching with the camera.",
+            PropertyList(),
+            [camera](const PropertyList& properties) -> ReturnValue {
+                camera->StopWatching();
+                return true;
             });
     }
 
+#if CONFIG_USE_TELEMETRY
+    AddTool("self.get_boot_timeline",
+        "Start time and duration in milliseconds of each phase of the last boot. "
+        "Only use this tool when the user asks why the device starts slowly.",
+        PropertyList(),
+        [](const PropertyList& properties) -> ReturnValue {
+            return Application::GetInstance().GetBootTimelineJson();
+        });
+
+    AddTool("self.get_telemetry",
+        "Diagnostics of the device: free memory over time, and the CPU usage and minimum free stack of each task. "
+        "Only use this tool when the user asks about the performance or memory of the device.\n"
+        "Args:\n"
+        "  `minutes`: How many recent minutes to return.",
+        PropertyList({
+            Property("minutes", kPropertyTypeInteger, std::min(5, CONFIG_TELEMETRY_HISTORY_MINUTES), 1, CONFIG_TELEMETRY_HISTORY_MINUTES)
+        }),
+        [](const PropertyList& properties) -> ReturnValue {
+            return Telemetry::GetInstance().GetJson(properties["minutes"].value<int>());
+        });
+#endif
+
     // Restore the original tools list to the end of the tools list
     tools_.insert(tools_.end(), original_tools.begin(), original_tools.end());
+    tools_pages_dirty_ = true;
 }
 
 void McpServer::AddTool(McpTool* tool) {
     // Prevent adding duplicate tools
-    if (std::find_if(tools_.begin(), tools_.end(), [tool](const McpTool* t) { return t->name() == tool->name(); }) != tools_.end()) {
+    if (tools_by_name_.find(tool->name()) != tools_by_name_.end()) {
         ESP_LOGW(TAG, "Tool %s already added", tool->name().c_str());
         return;
     }
 
     ESP_LOGI(TAG, "Add tool: %s", tool->name().c_str());
     tools_.push_back(tool);
+    tools_by_name_[tool->name()] = tool;
+    tools_pages_dirty_ = true;
 }
 
-void McpServer::AddTool(const std::string& name, const std::string& description, const PropertyList& properties, std::function<ReturnValue(const PropertyList&)> callback) {
-    AddTool(new McpTool(name, description, properties, callback));
+void McpServer::AddTool(const std::string& name, const std::string& description, const PropertyList& properties, std::function<ReturnValue(const PropertyList&)> callback,
+    ToolExecution execution, int max_concurrency, int timeout_ms) {
+    AddTool(new McpTool(name, description, properties, callback, execution, max_concurrency, timeout_ms));
 }
 
 void McpServer::ParseMessage(const std::string& message) {
@@ -148,7 +222,61 @@ void McpServer::ParseCapabilities(const cJSON* capabilities) {
     }
 }
 
+// Returns true and the id if the message is a valid request that will be replied
+static bool GetRequestId(const cJSON* json, int& id) {
+    auto version = cJSON_GetObjectItem(json, "jsonrpc");
+    if (!cJSON_IsString(version) || strcmp(version->valuestring, "2.0") != 0) {
+        return false;
+    }
+    auto method = cJSON_GetObjectItem(json, "method");
+    if (!cJSON_IsString(method) || strncmp(method->valuestring, "notifications", 13) == 0) {
+        return false;
+    }
+    auto params = cJSON_GetObjectItem(json, "params");
+    if (params != nullptr && !cJSON_IsObject(params)) {
+        return false;
+    }
+    auto id_item = cJSON_GetObjectItem(json, "id");
+    if (!cJSON_IsNumber(id_item)) {
+        return false;
+    }
+    id = id_item->valueint;
+    return true;
+}
+
+void McpServer::ParseBatch(const cJSON* json) {
+    // Register the ids of all requests first, since some replies are sent while parsing
+    auto batch = std::make_shared<ReplyBatch>();
+    batch->deadline_us = esp_timer_get_time() + MCP_BATCH_TIMEOUT_MS * 1000LL;
+    std::vector<const cJSON*> messages;
+    {
+        std::lock_guard<std::mutex> lock(batch_mutex_);
+        const cJSON* item;
+        cJSON_ArrayForEach(item, json) {
+            int id;
+            if (GetRequestId(item, id)) {
+                if (batch_by_id_.find(id) != batch_by_id_.end()) {
+                    ESP_LOGE(TAG, "Duplicate id in batch: %d", id);
+                    continue;
+                }
+                batch_by_id_[id] = batch;
+                batch->remaining++;
+            }
+            messages.push_back(item);
+        }
+    }
+
+    for (auto message : messages) {
+        ParseMessage(message);
+    }
+}
+
 void McpServer::ParseMessage(const cJSON* json) {
+    if (cJSON_IsArray(json)) {
+        ParseBatch(json);
+        return;
+    }
+
     // Check JSONRPC version
     auto version = cJSON_GetObjectItem(json, "jsonrpc");
     if (version == nullptr || !cJSON_IsString(version) || strcmp(version->valuestring, "2.0") != 0) {
@@ -189,6 +317,11 @@ void McpServer::ParseMessage(const cJSON* json) {
                 ParseCapabilities(capabilities);
             }
         }
+        {
+            std::lock_guard<std::mutex> lock(notify_mutex_);
+            notifications_enabled_ = true;
+            sent_values_.clear();
+        }
         auto app_desc = esp_app_get_description();
         std::string message = "{\"protocolVersion\":\"2024-11-05\",\"capabilities\":{\"tools\":{}},\"serverInfo\":{\"name\":\"" BOARD_NAME "\",\"version\":\"";
         message += app_desc->version;
@@ -233,7 +366,7 @@ void McpServer::ReplyResult(int id, const std::string& result) {
     payload += std::to_string(id) + ",\"result\":";
     payload += result;
     payload += "}";
-    Application::GetInstance().SendMcpMessage(payload);
+    SendReply(id, payload);
 }
 
 void McpServer::ReplyError(int id, const std::string& message) {
@@ -242,73 +375,233 @@ void McpServer::ReplyError(int id, const std::string& message) {
     payload += ",\"error\":{\"message\":\"";
     payload += message;
     payload += "\"}}";
-    Application::GetInstance().SendMcpMessage(payload);
+    SendReply(id, payload);
 }
 
-void McpServer::GetToolsList(int id, const std::string& cursor) {
-    const int max_payload_size = 8000;
-    std::string json = "{\"tools\":[";
-    
-    bool found_cursor = cursor.empty();
-    auto it = tools_.begin();
-    std::string next_cursor = "";
-    
-    while (it != tools_.end()) {
-        // 如果我们还没有找到起始位置，继续搜索
-        if (!found_cursor) {
-            if ((*it)->name() == cursor) {
-                found_cursor = true;
-            } else {
+void McpServer::SendReply(int id, const std::string& payload) {
+    std::string message;
+    {
+        std::lock_guard<std::mutex> lock(batch_mutex_);
+        auto it = batch_by_id_.find(id);
+        if (it == batch_by_id_.end()) {
+            message = payload;
+        } else {
+            auto batch = it->second;
+            batch_by_id_.erase(it);
+            if (batch->payload.length() > 1) {
+                batch->payload += ",";
+            }
+            batch->payload += payload;
+            if (--batch->remaining > 0) {
+                return;
+            }
+            batch->payload += "]";
+            message = std::move(batch->payload);
+        }
+    }
+    Application::GetInstance().SendMcpMessage(message);
+}
+
+// Send what has been collected for batches whose deadline passed, later replies are sent on their own
+void McpServer::CheckBatchTimeouts() {
+    std::vector<std::string> messages;
+    {
+        std::lock_guard<std::mutex> lock(batch_mutex_);
+        auto now = esp_timer_get_time();
+        for (auto it = batch_by_id_.begin(); it != batch_by_id_.end();) {
+            auto batch = it->second;
+            if (now < batch->deadline_us) {
                 ++it;
                 continue;
             }
+            ESP_LOGW(TAG, "Batch reply timeout, request %d not replied", it->first);
+            it = batch_by_id_.erase(it);
+            if (--batch->remaining == 0 && batch->payload.length() > 1) {
+                batch->payload += "]";
+                messages.push_back(std::move(batch->payload));
+            }
+        }
+    }
+
+    for (auto& message : messages) {
+        Application::GetInstance().SendMcpMessage(message);
+    }
+}
+
+void McpServer::NotifyPropertyChanged(const std::string& path, const ReturnValue& value) {
+    std::lock_guard<std::mutex> lock(notify_mutex_);
+    if (!notifications_enabled_) {
+        return;
+    }
+
+    auto it = sent_values_.find(path);
+    if (it != sent_values_.end() && it->second == value) {
+        // Changed back to the value already sent, nothing to report
+        pending_changes_.erase(path);
+        return;
+    }
+
+    bool start_timer = pending_changes_.empty();
+    pending_changes_[path] = value;
+    if (start_timer) {
+        esp_timer_start_once(notify_timer_, MCP_NOTIFY_COALESCE_MS * 1000);
+    }
+}
+
+void McpServer::CloseSession() {
+    {
+        std::lock_guard<std::mutex> lock(notify_mutex_);
+        notifications_enabled_ = false;
+        pending_changes_.clear();
+        sent_values_.clear();
+        esp_timer_stop(notify_timer_);
+    }
+    {
+        std::lock_guard<std::mutex> lock(batch_mutex_);
+        batch_by_id_.clear();
+    }
+
+    // 下一个会话需要重新收到网络状态
+    auto display = Board::GetInstance().GetDisplay();
+    if (display != nullptr) {
+        display->ResetNetworkNotification();
+    }
+}
+
+bool McpServer::IsSessionOpen() {
+    std::lock_guard<std::mutex> lock(notify_mutex_);
+    return notifications_enabled_;
+}
+
+void McpServer::SendNotification(const std::string& method, const std::string& params) {
+    if (!IsSessionOpen()) {
+        return;
+    }
+    std::string payload = "{\"jsonrpc\":\"2.0\",\"method\":\"";
+    payload += method;
+    payload += "\",\"params\":";
+    payload += params;
+    payload += "}";
+    Application::GetInstance().SendMcpMessage(payload);
+}
+
+void McpServer::SendPropertyChanges() {
+    /*
+     * 合并后的属性变化以增量方式发送，例如：
+     * {"jsonrpc":"2.0","method":"notifications/state_changed","params":{"changes":{"audio_speaker.volume":80}}}
+     */
+    auto changes = cJSON_CreateObject();
+    {
+        std::lock_guard<std::mutex> lock(notify_mutex_);
+        for (auto& [path, value] : pending_changes_) {
+            if (std::holds_alternative<bool>(value)) {
+                cJSON_AddBoolToObject(changes, path.c_str(), std::get<bool>(value));
+            } else if (std::holds_alternative<int>(value)) {
+                cJSON_AddNumberToObject(changes, path.c_str(), std::get<int>(value));
+            } else {
+                cJSON_AddStringToObject(changes, path.c_str(), std::get<std::string>(value).c_str());
+            }
+            sent_values_[path] = value;
         }
-        
-        // 添加tool前检查大小
-        std::string tool_json = (*it)->to_json() + ",";
-        if (json.length() + tool_json.length() + 30 > max_payload_size) {
-            // 如果添加这个tool会超出大小限制，设置next_cursor并退出循环
-            next_cursor = (*it)->name();
-            break;
+        pending_changes_.clear();
+    }
+
+    if (changes->child == nullptr) {
+        cJSON_Delete(changes);
+        return;
+    }
+
+    auto root = cJSON_CreateObject();
+    cJSON_AddStringToObject(root, "jsonrpc", "2.0");
+    cJSON_AddStringToObject(root, "method", "notifications/state_changed");
+    auto params = cJSON_CreateObject();
+    cJSON_AddItemToObject(params, "changes", changes);
+    cJSON_AddItemToObject(root, "params", params);
+
+    auto json_str = cJSON_PrintUnformatted(root);
+    std::string payload(json_str);
+    cJSON_free(json_str);
+    cJSON_Delete(root);
+    Application::GetInstance().SendMcpMessage(payload);
+}
+
+void McpServer::BuildToolsPages() {
+    const size_t max_payload_size = 8000;
+    tools_pages_.clear();
+    tools_page_index_.clear();
+
+    const std::string page_header = "{\"tools\":[";
+    std::string json = page_header;
+    std::string page_cursor = "";
+    for (auto tool : tools_) {
+        auto& tool_json = tool->to_json();
+        if (page_header.length() + tool_json.length() + 1 + 30 > max_payload_size) {
+            // 单个 tool 已超出大小限制，跳过它以免影响其他 tool 的列出
+            ESP_LOGE(TAG, "tools/list: Tool %s exceeds the payload size limit", tool->name().c_str());
+            continue;
+        }
+        if (json.length() + tool_json.length() + 1 + 30 > max_payload_size) {
+            // 当前页已满，以当前 tool 作为下一页的 cursor
+            json.pop_back();
+            json += "],\"nextCursor\":\"" + tool->name() + "\"}";
+            tools_page_index_[page_cursor] = tools_pages_.size();
+            tools_pages_.push_back(std::move(json));
+
+            json = page_header;
+            page_cursor = tool->name();
         }
-        
         json += tool_json;
-        ++it;
+        json += ",";
     }
-    
+
     if (json.back() == ',') {
         json.pop_back();
     }
-    
-    if (json.back() == '[' && !tools_.empty()) {
-        // 如果没有添加任何tool，返回错误
-        ESP_LOGE(TAG, "tools/list: Failed to add tool %s because of payload size limit", next_cursor.c_str());
-        ReplyError(id, "Failed to add tool " + next_cursor + " because of payload size limit");
-        return;
+    json += "]}";
+    tools_page_index_[page_cursor] = tools_pages_.size();
+    tools_pages_.push_back(std::move(json));
+    tools_pages_dirty_ = false;
+    ESP_LOGI(TAG, "tools/list: %u tools in %u pages", tools_.size(), tools_pages_.size());
+}
+
+void McpServer::GetToolsList(int id, const std::string& cursor) {
+    if (tools_pages_dirty_) {
+        BuildToolsPages();
     }
 
-    if (next_cursor.empty()) {
-        json += "]}";
-    } else {
-        json += "],\"nextCursor\":\"" + next_cursor + "\"}";
+    auto it = tools_page_index_.find(cursor);
+    if (it == tools_page_index_.end()) {
+        ESP_LOGE(TAG, "tools/list: Invalid cursor %s", cursor.c_str());
+        ReplyError(id, "Invalid cursor: " + cursor);
+        return;
     }
-    
-    ReplyResult(id, json);
+    ReplyResult(id, tools_pages_[it->second]);
 }
 
 void McpServer::DoToolCall(int id, const std::string& tool_name, const cJSON* tool_arguments) {
-    auto tool_iter = std::find_if(tools_.begin(), tools_.end(), 
-                                 [&tool_name](const McpTool* tool) { 
-                                     return tool->name() == tool_name; 
-                                 });
-    
-    if (tool_iter == tools_.end()) {
+    auto tool_iter = tools_by_name_.find(tool_name);
+    if (tool_iter == tools_by_name_.end()) {
         ESP_LOGE(TAG, "tools/call: Unknown tool: %s", tool_name.c_str());
         ReplyError(id, "Unknown tool: " + tool_name);
         return;
     }
+    auto tool = tool_iter->second;
 
-    PropertyList arguments = (*tool_iter)->properties();
+    // Sync tools without arguments are called with their own (empty) property list, no binding needed
+    if (tool->execution() == kToolExecutionSync && tool->properties().empty()) {
+        Application::GetInstance().Schedule([this, id, tool]() {
+            try {
+                ReplyResult(id, tool->Call(tool->properties()));
+            } catch (const std::runtime_error& e) {
+                ESP_LOGE(TAG, "tools/call: %s", e.what());
+                ReplyError(id, e.what());
+            }
+        });
+        return;
+    }
+
+    // Bind the arguments into a single copy of the schema, which is then moved into the task
+    PropertyList arguments = tool->properties();
     for (auto& argument : arguments) {
         bool found = false;
         if (cJSON_IsObject(tool_arguments)) {
@@ -332,12 +625,140 @@ void McpServer::DoToolCall(int id, const std::string& tool_name, const cJSON* to
         }
     }
 
-    Application::GetInstance().Schedule([this, id, tool_iter, arguments = std::move(arguments)]() {
+    if (tool->execution() == kToolExecutionAsync) {
+        SubmitToolCall(id, tool, std::move(arguments));
+        return;
+    }
+
+    Application::GetInstance().Schedule([this, id, tool, arguments = std::move(arguments)]() {
         try {
-            ReplyResult(id, (*tool_iter)->Call(arguments));
+            ReplyResult(id, tool->Call(arguments));
         } catch (const std::runtime_error& e) {
             ESP_LOGE(TAG, "tools/call: %s", e.what());
             ReplyError(id, e.what());
         }
     });
+}
+
+void McpServer::SubmitToolCall(int id, McpTool* tool, PropertyList&& arguments) {
+    std::string error;
+    {
+        std::lock_guard<std::mutex> lock(tool_mutex_);
+        auto& active_calls = tool_active_calls_[tool];
+        if (pending_tool_calls_.find(id) != pending_tool_calls_.end()) {
+            error = "Duplicate request id: " + std::to_string(id);
+        } else if (active_calls >= tool->max_concurrency()) {
+            error = "Tool is busy: " + tool->name();
+        } else {
+            active_calls++;
+            int64_t deadline = 0;
+            if (tool->timeout_ms() > 0) {
+                deadline = esp_timer_get_time() + (int64_t)tool->timeout_ms() * 1000;
+            }
+            pending_tool_calls_[id] = deadline;
+            tool_jobs_.push_back({id, tool, std::move(arguments)});
+            StartToolWorkers();
+        }
+    }
+
+    if (!error.empty()) {
+        ESP_LOGW(TAG, "tools/call: %s", error.c_str());
+        ReplyError(id, error);
+        return;
+    }
+    tool_cv_.notify_one();
+}
+
+// The workers are only created when the first async tool is called, must be called with tool_mutex_ held
+void McpServer::StartToolWorkers() {
+    if (!tool_workers_.empty()) {
+        return;
+    }
+
+    for (int i = 0; i < MCP_TOOL_WORKER_COUNT; i++) {
+        TaskHandle_t handle = nullptr;
+        xTaskCreate([](void* arg) {
+            McpServer* server = (McpServer*)arg;
+            server->ToolWorkerLoop();
+            vTaskDelete(NULL);
+        }, "mcp_tool", MCP_TOOL_WORKER_STACK_SIZE, this, 2, &handle);
+        tool_workers_.push_back(handle);
+    }
+
+    esp_timer_create_args_t timer_args = {
+        .callback = [](void* arg) {
+            McpServer* server = (McpServer*)arg;
+            server->CheckToolTimeouts();
+            server->CheckBatchTimeouts();
+        },
+        .arg = this,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "mcp_tool_timeout",
+        .skip_unhandled_events = true
+    };
+    esp_timer_create(&timer_args, &tool_timeout_timer_);
+    esp_timer_start_periodic(tool_timeout_timer_, MCP_TOOL_TIMEOUT_CHECK_INTERVAL_MS * 1000);
+}
+
+void McpServer::ToolWorkerLoop() {
+    while (true) {
+        std::unique_lock<std::mutex> lock(tool_mutex_);
+        tool_cv_.wait(lock, [this]() { return !tool_jobs_.empty(); });
+        auto job = std::move(tool_jobs_.front());
+        tool_jobs_.pop_front();
+
+        // Already timed out while waiting in the queue
+        if (pending_tool_calls_.find(job.id) == pending_tool_calls_.end()) {
+            tool_active_calls_[job.tool]--;
+            continue;
+        }
+        lock.unlock();
+
+        std::string result;
+        std::string error;
+        auto start_time = esp_timer_get_time();
+        try {
+            result = job.tool->Call(job.arguments);
+        } catch (const std::runtime_error& e) {
+            error = e.what();
+        }
+        int elapsed_ms = (esp_timer_get_time() - start_time) / 1000;
+
+        lock.lock();
+        tool_active_calls_[job.tool]--;
+        bool timed_out = pending_tool_calls_.erase(job.id) == 0;
+        lock.unlock();
+
+        if (timed_out) {
+            ESP_LOGW(TAG, "tools/call: %s finished after timeout (%d ms), result discarded", job.tool->name().c_str(), elapsed_ms);
+        } else if (!error.empty()) {
+            ESP_LOGE(TAG, "tools/call: %s", error.c_str());
+            ReplyError(job.id, error);
+        } else {
+            ESP_LOGI(TAG, "tools/call: %s done in %d ms", job.tool->name().c_str(), elapsed_ms);
+            ReplyResult(job.id, result);
+        }
+    }
+}
+
+void McpServer::CheckToolTimeouts() {
+    std::vector<int> expired;
+    {
+        std::lock_guard<std::mutex> lock(tool_mutex_);
+        auto now = esp_timer_get_time();
+        for (auto it = pending_tool_calls_.begin(); it != pending_tool_calls_.end();) {
+            if (it->second != 0 && now >= it->second) {
+                expired.push_back(it->first);
+                it = pending_tool_calls_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    // 超时的调用立即回复错误，工具线程稍后完成时会丢弃其结果
+    for (auto id : expired) {
+        ESP_LOGW(TAG, "tools/call: Request %d timeout", id);
+        ReplyError(id, "Tool call timeout");
+    }
 }
\ No newline at end of file
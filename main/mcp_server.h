@@ -4,16 +4,39 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <functional>
 #include <variant>
 #include <optional>
 #include <stdexcept>
+#include <list>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
 
 #include <cJSON.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// 异步工具线程池的线程数和栈大小（拍照解释需要做 HTTPS 上传，栈不能太小）
+#define MCP_TOOL_WORKER_COUNT 2
+#define MCP_TOOL_WORKER_STACK_SIZE (4096 * 2)
+#define MCP_TOOL_TIMEOUT_CHECK_INTERVAL_MS 500
+// 属性变化在该时间窗口内合并为一条通知
+#define MCP_NOTIFY_COALESCE_MS 200
+// 批量请求中未回复的请求超过该时间后放弃等待，已收集的回复先发送
+#define MCP_BATCH_TIMEOUT_MS 60000
 
 // 添加类型别名
 using ReturnValue = std::variant<bool, int, std::string>;
 
+// Sync tools are fast and run on the main loop, async tools are slow and run on the tool workers
+enum ToolExecution {
+    kToolExecutionSync,
+    kToolExecutionAsync
+};
+
 enum PropertyType {
     kPropertyTypeBoolean,
     kPropertyTypeInteger,
@@ -85,7 +108,8 @@ public:
         value_ = value;
     }
 
-    std::string to_json() const {
+    // Build the JSON schema of this property as a cJSON object, the caller owns the result
+    cJSON* to_json_object() const {
         cJSON *json = cJSON_CreateObject();
         
         if (type_ == kPropertyTypeBoolean) {
@@ -110,7 +134,11 @@ public:
                 cJSON_AddStringToObject(json, "default", value<std::string>().c_str());
             }
         }
-        
+        return json;
+    }
+
+    std::string to_json() const {
+        cJSON *json = to_json_object();
         char *json_str = cJSON_PrintUnformatted(json);
         std::string result(json_str);
         cJSON_free(json_str);
@@ -153,13 +181,19 @@ public:
         return required;
     }
 
-    std::string to_json() const {
+    inline bool empty() const { return properties_.empty(); }
+
+    // Build the JSON schema of all properties as a cJSON object, the caller owns the result
+    cJSON* to_json_object() const {
         cJSON *json = cJSON_CreateObject();
-        
         for (const auto& property : properties_) {
-            cJSON *prop_json = cJSON_Parse(property.to_json().c_str());
-            cJSON_AddItemToObject(json, property.name().c_str(), prop_json);
+            cJSON_AddItemToObject(json, property.name().c_str(), property.to_json_object());
         }
+        return json;
+    }
+
+    std::string to_json() const {
+        cJSON *json = to_json_object();
         
         char *json_str = cJSON_PrintUnformatted(json);
         std::string result(json_str);
@@ -176,22 +210,13 @@ private:
     std::string description_;
     PropertyList properties_;
     std::function<ReturnValue(const PropertyList&)> callback_;
+    ToolExecution execution_;
+    int max_concurrency_;
+    int timeout_ms_;
+    // The tool definition never changes after registration, so the schema is rendered only once
+    std::string json_;
 
-public:
-    McpTool(const std::string& name, 
-            const std::string& description, 
-            const PropertyList& properties, 
-            std::function<ReturnValue(const PropertyList&)> callback)
-        : name_(name), 
-        description_(description), 
-        properties_(properties), 
-        callback_(callback) {}
-
-    inline const std::string& name() const { return name_; }
-    inline const std::string& description() const { return description_; }
-    inline const PropertyList& properties() const { return properties_; }
-
-    std::string to_json() const {
+    std::string BuildJson() const {
         std::vector<std::string> required = properties_.GetRequired();
         
         cJSON *json = cJSON_CreateObject();
@@ -200,9 +225,7 @@ public:
         
         cJSON *input_schema = cJSON_CreateObject();
         cJSON_AddStringToObject(input_schema, "type", "object");
-        
-        cJSON *properties = cJSON_Parse(properties_.to_json().c_str());
-        cJSON_AddItemToObject(input_schema, "properties", properties);
+        cJSON_AddItemToObject(input_schema, "properties", properties_.to_json_object());
         
         if (!required.empty()) {
             cJSON *required_array = cJSON_CreateArray();
@@ -222,6 +245,33 @@ public:
         return result;
     }
 
+public:
+    McpTool(const std::string& name, 
+            const std::string& description, 
+            const PropertyList& properties, 
+            std::function<ReturnValue(const PropertyList&)> callback,
+            ToolExecution execution = kToolExecutionSync,
+            int max_concurrency = 1,
+            int timeout_ms = 0)
+        : name_(name), 
+        description_(description), 
+        properties_(properties), 
+        callback_(callback),
+        execution_(execution),
+        max_concurrency_(max_concurrency),
+        timeout_ms_(timeout_ms) {
+        json_ = BuildJson();
+    }
+
+    inline const std::string& name() const { return name_; }
+    inline const std::string& description() const { return description_; }
+    inline const PropertyList& properties() const { return properties_; }
+    inline const std::string& to_json() const { return json_; }
+    inline ToolExecution execution() const { return execution_; }
+    // Only apply to async tools, a timeout of 0 means no timeout
+    inline int max_concurrency() const { return max_concurrency_; }
+    inline int timeout_ms() const { return timeout_ms_; }
+
     std::string Call(const PropertyList& properties) {
         ReturnValue return_value = callback_(properties);
         // 返回结果
@@ -257,23 +307,79 @@ public:
 
     void AddCommonTools();
     void AddTool(McpTool* tool);
-    void AddTool(const std::string& name, const std::string& description, const PropertyList& properties, std::function<ReturnValue(const PropertyList&)> callback);
+    void AddTool(const std::string& name, const std::string& description, const PropertyList& properties, std::function<ReturnValue(const PropertyList&)> callback,
+        ToolExecution execution = kToolExecutionSync, int max_concurrency = 1, int timeout_ms = 0);
     void ParseMessage(const cJSON* json);
     void ParseMessage(const std::string& message);
+    // Report a change of a watched device property, e.g. ("audio_speaker.volume", 80)
+    void NotifyPropertyChanged(const std::string& path, const ReturnValue& value);
+    // Send a notification with the params given as a JSON object string, dropped when no session is open
+    void SendNotification(const std::string& method, const std::string& params);
+    // True after the client has sent `initialize` and until CloseSession
+    bool IsSessionOpen();
+    // Stop notifications until the next client sends `initialize`
+    void CloseSession();
 
 private:
     McpServer();
     ~McpServer();
 
     void ParseCapabilities(const cJSON* capabilities);
+    void ParseBatch(const cJSON* json);
 
     void ReplyResult(int id, const std::string& result);
     void ReplyError(int id, const std::string& message);
+    void SendReply(int id, const std::string& payload);
+    void SendPropertyChanges();
 
     void GetToolsList(int id, const std::string& cursor);
     void DoToolCall(int id, const std::string& tool_name, const cJSON* tool_arguments);
+    void BuildToolsPages();
+    void SubmitToolCall(int id, McpTool* tool, PropertyList&& arguments);
+    void StartToolWorkers();
+    void ToolWorkerLoop();
+    void CheckToolTimeouts();
+    void CheckBatchTimeouts();
 
     std::vector<McpTool*> tools_;
+    std::unordered_map<std::string, McpTool*> tools_by_name_;
+
+    // Pre-rendered `tools/list` results, one per page, rebuilt only after the tool list changes
+    std::vector<std::string> tools_pages_;
+    // Maps a cursor (the name of the first tool on a page) to its page index
+    std::unordered_map<std::string, size_t> tools_page_index_;
+    bool tools_pages_dirty_ = true;
+
+    // Async tool calls waiting for a worker
+    struct ToolCallJob {
+        int id;
+        McpTool* tool;
+        PropertyList arguments;
+    };
+    std::mutex tool_mutex_;
+    std::condition_variable tool_cv_;
+    std::list<ToolCallJob> tool_jobs_;
+    // Request id -> deadline (us, 0 = none) of async calls not yet replied
+    std::map<int, int64_t> pending_tool_calls_;
+    std::unordered_map<McpTool*, int> tool_active_calls_;
+    std::vector<TaskHandle_t> tool_workers_;
+    esp_timer_handle_t tool_timeout_timer_ = nullptr;
+
+    // Property change notifications, only sent after the client is initialized
+    std::mutex notify_mutex_;
+    bool notifications_enabled_ = false;
+    std::map<std::string, ReturnValue> pending_changes_;
+    std::map<std::string, ReturnValue> sent_values_;
+    esp_timer_handle_t notify_timer_ = nullptr;
+
+    // Replies to a batch request are collected and sent as one array
+    struct ReplyBatch {
+        int remaining = 0;
+        int64_t deadline_us = 0;
+        std::string payload = "[";
+    };
+    std::mutex batch_mutex_;
+    std::map<int, std::shared_ptr<ReplyBatch>> batch_by_id_;
 };
 
 #endif // MCP_SERVER_H
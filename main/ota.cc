@@ -1,6 +1,8 @@
 #include "ota.h"
 #include "system_info.h"
 #include "settings.h"
+#include "ota_patch.h"
+#include "ota_decompressor.h"
 #include "assets/lang_config.h"
 
 #include <cJSON.h>
@@ -8,8 +10,16 @@
 #include <esp_partition.h>
 #include <esp_ota_ops.h>
 #include <esp_app_format.h>
+#include <esp_image_format.h>
 #include <esp_efuse.h>
 #include <esp_efuse_table.h>
+#include <esp_flash_encrypt.h>
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+#include <spi_flash_mmap.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
 #ifdef SOC_HMAC_SUPPORTED
 #include <esp_hmac.h>
 #endif
@@ -18,6 +28,7 @@
 #include <vector>
 #include <sstream>
 #include <algorithm>
+#include <atomic>
 
 #define TAG "Ota"
 
@@ -202,6 +213,17 @@ bool Ota::CheckVersion() {
         if (cJSON_IsString(url)) {
             firmware_url_ = url->valuestring;
         }
+        // 可选的差分补丁，只有基于当前版本生成的补丁才可以使用，例如
+        // "patch": { "base": "1.0.0", "url": "http://" }
+        patch_url_.clear();
+        cJSON *patch = cJSON_GetObjectItem(firmware, "patch");
+        if (cJSON_IsObject(patch)) {
+            cJSON *base = cJSON_GetObjectItem(patch, "base");
+            cJSON *patch_url = cJSON_GetObjectItem(patch, "url");
+            if (cJSON_IsString(base) && cJSON_IsString(patch_url) && current_version_ == base->valuestring) {
+                patch_url_ = patch_url->valuestring;
+            }
+        }
 
         if (cJSON_IsString(version) && cJSON_IsString(url)) {
             // Check if the version is newer, for example, 0.1.0 is newer than 0.0.1
@@ -245,106 +267,466 @@ void Ota::MarkCurrentVersionValid() {
     }
 }
 
-void Ota::Upgrade(const std::string& firmware_url) {
-    ESP_LOGI(TAG, "Upgrading firmware from %s", firmware_url.c_str());
-    esp_ota_handle_t update_handle = 0;
+#define OTA_IMAGE_HEADER_SIZE (sizeof(esp_image_header_t) + sizeof(esp_image_segment_header_t) + sizeof(esp_app_desc_t))
+
+static bool CheckImageHeader(const uint8_t* data, size_t size) {
+    if (size < OTA_IMAGE_HEADER_SIZE) {
+        ESP_LOGE(TAG, "Firmware is too small");
+        return false;
+    }
+    esp_app_desc_t new_app_info;
+    memcpy(&new_app_info, data + sizeof(esp_image_header_t) + sizeof(esp_image_segment_header_t), sizeof(esp_app_desc_t));
+    ESP_LOGI(TAG, "New firmware version: %s", new_app_info.version);
+
+    auto current_version = esp_app_get_description()->version;
+    if (memcmp(new_app_info.version, current_version, sizeof(new_app_info.version)) == 0) {
+        ESP_LOGE(TAG, "Firmware version is the same, skipping upgrade");
+        return false;
+    }
+    return true;
+}
+
+// 写入任务从 full_chunks 取出数据块，擦除并写入 flash 后放回 free_chunks，收到 nullptr 时结束
+struct OtaWriter {
+    const esp_partition_t* partition = nullptr;
+    esp_ota_handle_t handle = 0;
+    QueueHandle_t free_chunks = nullptr;
+    QueueHandle_t full_chunks = nullptr;
+    TaskHandle_t producer = nullptr;
+    // 开启 flash 加密时只能顺序写入，由 esp_ota_write 内部擦除，此时不支持断点续传
+    // 否则提前擦除并用 esp_partition_write 写到指定位置，OTA 句柄只用于 esp_ota_begin 的检查
+    bool sequential = false;
+    size_t saved = 0;
+    // 下载的数据依次经过解压和补丁还原后再写入，两者都是可选的
+    OtaDecompressor* decompressor = nullptr;
+    OtaPatcher* patcher = nullptr;
+    // 在写入的固件数据上检查固件头，续传时已经检查过
+    bool header_checked = false;
+    std::string image_header;
+
+    std::atomic<esp_err_t> result = ESP_OK;
+    std::atomic<size_t> written = 0;
+    size_t erased = 0;
+    int64_t wait_us = 0;
+    int64_t erase_us = 0;
+    int64_t write_us = 0;
+
+    void Run() {
+        while (true) {
+            OtaChunk* chunk = nullptr;
+            auto start_time = esp_timer_get_time();
+            xQueueReceive(full_chunks, &chunk, portMAX_DELAY);
+            wait_us += esp_timer_get_time() - start_time;
+            if (chunk == nullptr) {
+                break;
+            }
+            if (result == ESP_OK) {
+                result = Feed(chunk->data, chunk->size);
+                if (result == ESP_OK && IsResumable() && written - saved >= OTA_RESUME_SAVE_INTERVAL) {
+                    SaveProgress();
+                }
+            }
+            xQueueSend(free_chunks, &chunk, portMAX_DELAY);
+        }
+        if (result == ESP_OK && decompressor != nullptr) {
+            result = decompressor->Finish();
+        }
+        if (result == ESP_OK && patcher != nullptr) {
+            result = patcher->Finish();
+        }
+        if (result == ESP_OK && IsResumable()) {
+            SaveProgress();
+        }
+        xTaskNotifyGive(producer);
+    }
+
+    bool IsResumable() const {
+        return !sequential && patcher == nullptr && decompressor == nullptr;
+    }
+
+    esp_err_t Feed(const uint8_t* data, size_t size) {
+        if (decompressor != nullptr) {
+            return decompressor->Feed(data, size);
+        } else if (patcher != nullptr) {
+            return patcher->Feed(data, size);
+        }
+        return Write(data, size);
+    }
+
+    // 只记录已经写入 flash 的字节数
+    void SaveProgress() {
+        Settings settings("ota", true);
+        settings.SetInt("written", written);
+        saved = written;
+        // 进度不等待延迟提交，断电后也能从这里继续
+        Settings::Flush();
+    }
+
+    esp_err_t Write(const uint8_t* data, size_t size) {
+        if (!header_checked) {
+            image_header.append((const char*)data, std::min(size, OTA_IMAGE_HEADER_SIZE - image_header.size()));
+            if (image_header.size() >= OTA_IMAGE_HEADER_SIZE) {
+                if (!CheckImageHeader((const uint8_t*)image_header.data(), image_header.size())) {
+                    return ESP_ERR_INVALID_VERSION;
+                }
+                header_checked = true;
+                std::string().swap(image_header);
+            }
+        }
+
+        size_t offset = written;
+        if (!sequential && offset + size > erased) {
+            size_t erase_end = (offset + size + SPI_FLASH_SEC_SIZE - 1) & ~(SPI_FLASH_SEC_SIZE - 1);
+            if (erase_end > partition->size) {
+                ESP_LOGE(TAG, "Firmware is larger than partition %s", partition->label);
+                return ESP_ERR_INVALID_SIZE;
+            }
+            auto start_time = esp_timer_get_time();
+            auto err = esp_partition_erase_range(partition, erased, erase_end - erased);
+            erase_us += esp_timer_get_time() - start_time;
+            if (err != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to erase flash: %s", esp_err_to_name(err));
+                return err;
+            }
+            erased = erase_end;
+        }
+
+        auto start_time = esp_timer_get_time();
+        auto err = sequential ? esp_ota_write(handle, data, size) : esp_partition_write(partition, offset, data, size);
+        write_us += esp_timer_get_time() - start_time;
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to write OTA data: %s", esp_err_to_name(err));
+            return err;
+        }
+        written += size;
+        return ESP_OK;
+    }
+};
+
+// 校验分区中的完整镜像，与 esp_ota_end 的校验相同
+static esp_err_t VerifyImage(const esp_partition_t* partition) {
+    const esp_partition_pos_t part_pos = {
+        .offset = partition->address,
+        .size = partition->size,
+    };
+    esp_image_metadata_t data;
+    if (esp_image_verify(ESP_IMAGE_VERIFY, &part_pos, &data) != ESP_OK) {
+        return ESP_ERR_OTA_VALIDATE_FAILED;
+    }
+    return ESP_OK;
+}
+
+static void ClearResumeState() {
+    Settings settings("ota", true);
+    settings.EraseAll();
+}
+
+bool Ota::Upgrade(const std::string& firmware_url, const std::string& version, bool is_patch) {
+    ESP_LOGI(TAG, "Upgrading firmware from %s%s", firmware_url.c_str(), is_patch ? " (patch)" : "");
     auto update_partition = esp_ota_get_next_update_partition(NULL);
     if (update_partition == NULL) {
         ESP_LOGE(TAG, "Failed to get update partition");
-        return;
+        return false;
     }
 
     ESP_LOGI(TAG, "Writing to partition %s at offset 0x%lx", update_partition->label, update_partition->address);
-    bool image_header_checked = false;
-    std::string image_header;
 
-    auto http = std::unique_ptr<Http>(Board::GetInstance().CreateHttp());
-    if (!http->Open("GET", firmware_url)) {
-        ESP_LOGE(TAG, "Failed to open HTTP connection");
-        return;
+    // 上次下载同一个固件时中断了，从已写入的位置继续下载到同一个分区
+    // 断点向下对齐到扇区，写入任务会先擦除这个扇区，再重新写入
+    size_t resume_offset = 0;
+    size_t resume_total = 0;
+    std::string etag;
+    if (!is_patch && !esp_flash_encryption_enabled()) {
+        Settings settings("ota", false);
+        if (settings.GetString("url") == firmware_url && settings.GetString("version") == version
+            && settings.GetString("partition") == update_partition->label) {
+            resume_total = settings.GetInt("total");
+            resume_offset = std::min<size_t>(settings.GetInt("written"), resume_total - 1) & ~(SPI_FLASH_SEC_SIZE - 1);
+            etag = settings.GetString("etag");
+        }
+    }
+
+    std::unique_ptr<Http> http;
+    size_t content_length = 0;
+    while (true) {
+        http.reset(Board::GetInstance().CreateHttp());
+        if (resume_offset > 0) {
+            http->SetHeader("Range", "bytes=" + std::to_string(resume_offset) + "-");
+            // 文件已经变化时服务器会返回完整的内容
+            if (!etag.empty()) {
+                http->SetHeader("If-Range", etag);
+            }
+        }
+        if (!http->Open("GET", firmware_url)) {
+            ESP_LOGE(TAG, "Failed to open HTTP connection");
+            return false;
+        }
+
+        int status_code = http->GetStatusCode();
+        content_length = http->GetBodyLength();
+        if (status_code == 206 && resume_offset > 0 && resume_offset + content_length == resume_total) {
+            ESP_LOGI(TAG, "Resuming download from %u/%u", resume_offset, resume_total);
+            content_length = resume_total;
+            break;
+        } else if (status_code == 200) {
+            if (resume_offset > 0) {
+                ESP_LOGW(TAG, "Server did not resume from %u, downloading from the beginning", resume_offset);
+                resume_offset = 0;
+            }
+            break;
+        } else if (status_code == 206 && resume_offset > 0) {
+            ESP_LOGW(TAG, "Firmware size changed, downloading from the beginning");
+            http->Close();
+            resume_offset = 0;
+            continue;
+        }
+        ESP_LOGE(TAG, "Failed to download firmware, status code: %d", status_code);
+        return false;
     }
 
-    size_t content_length = http->GetBodyLength();
     if (content_length == 0) {
         ESP_LOGE(TAG, "Failed to get content length");
-        return;
+        return false;
     }
-
-    char buffer[512];
-    size_t total_read = 0, recent_read = 0;
-    auto last_calc_time = esp_timer_get_time();
-    while (true) {
-        int ret = http->Read(buffer, sizeof(buffer));
-        if (ret < 0) {
-            ESP_LOGE(TAG, "Failed to read HTTP data: %s", esp_err_to_name(ret));
-            return;
+    if (resume_offset == 0) {
+        etag = http->GetResponseHeader("ETag");
+        if (etag.empty()) {
+            etag = http->GetResponseHeader("Last-Modified");
         }
+    }
 
-        // Calculate speed and progress every second
-        recent_read += ret;
-        total_read += ret;
-        if (esp_timer_get_time() - last_calc_time >= 1000000 || ret == 0) {
-            size_t progress = total_read * 100 / content_length;
-            ESP_LOGI(TAG, "Progress: %u%% (%u/%u), Speed: %uB/s", progress, total_read, content_length, recent_read);
-            if (upgrade_callback_) {
-                upgrade_callback_(progress, recent_read);
+    // 数据块优先放在 PSRAM 中，接收下一块的同时写入上一块
+    const size_t chunk_size = CONFIG_OTA_CHUNK_SIZE_KB * 1024;
+    OtaChunk chunks[OTA_CHUNK_COUNT] = {};
+    for (auto& chunk : chunks) {
+        chunk.data = (uint8_t*)heap_caps_malloc(chunk_size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (chunk.data == nullptr) {
+            chunk.data = (uint8_t*)heap_caps_malloc(chunk_size, MALLOC_CAP_8BIT);
+        }
+        if (chunk.data == nullptr) {
+            ESP_LOGE(TAG, "Failed to allocate OTA buffer");
+            for (auto& c : chunks) {
+                heap_caps_free(c.data);
             }
-            last_calc_time = esp_timer_get_time();
-            recent_read = 0;
+            return false;
         }
+    }
 
-        if (ret == 0) {
+    OtaWriter writer;
+    writer.partition = update_partition;
+    writer.producer = xTaskGetCurrentTaskHandle();
+    writer.sequential = esp_flash_encryption_enabled();
+    writer.written = resume_offset;
+    writer.erased = resume_offset;
+    writer.saved = resume_offset;
+    writer.header_checked = resume_offset > 0;
+    std::unique_ptr<OtaDecompressor> decompressor;
+    std::unique_ptr<OtaPatcher> patcher;
+    if (is_patch) {
+        patcher = std::make_unique<OtaPatcher>(esp_ota_get_running_partition(), [&writer](const uint8_t* data, size_t size) {
+            return writer.Write(data, size);
+        });
+        writer.patcher = patcher.get();
+    }
+    writer.free_chunks = xQueueCreate(OTA_CHUNK_COUNT, sizeof(OtaChunk*));
+    writer.full_chunks = xQueueCreate(OTA_CHUNK_COUNT + 1, sizeof(OtaChunk*));
+    for (auto& chunk : chunks) {
+        OtaChunk* p = &chunk;
+        xQueueSend(writer.free_chunks, &p, 0);
+    }
+    TaskHandle_t writer_task = nullptr;
+
+    bool success = false;
+    size_t total_read = resume_offset, recent_read = 0, speed = 0;
+    int64_t network_wait_us = 0;
+    auto start_time = esp_timer_get_time();
+    auto last_calc_time = start_time;
+    while (true) {
+        if (writer.result != ESP_OK) {
             break;
         }
 
-        if (!image_header_checked) {
-            image_header.append(buffer, ret);
-            if (image_header.size() >= sizeof(esp_image_header_t) + sizeof(esp_image_segment_header_t) + sizeof(esp_app_desc_t)) {
-                esp_app_desc_t new_app_info;
-                memcpy(&new_app_info, image_header.data() + sizeof(esp_image_header_t) + sizeof(esp_image_segment_header_t), sizeof(esp_app_desc_t));
-                ESP_LOGI(TAG, "New firmware version: %s", new_app_info.version);
+        // 等待空闲的数据块，等待时间即网络一侧因为 flash 写入而停顿的时间
+        OtaChunk* chunk = nullptr;
+        auto wait_start = esp_timer_get_time();
+        xQueueReceive(writer.free_chunks, &chunk, portMAX_DELAY);
+        network_wait_us += esp_timer_get_time() - wait_start;
+
+        chunk->size = 0;
+        int ret = 0;
+        while (chunk->size < chunk_size) {
+            ret = http->Read((char*)chunk->data + chunk->size, chunk_size - chunk->size);
+            if (ret <= 0) {
+                break;
+            }
+            chunk->size += ret;
+            total_read += ret;
+            recent_read += ret;
+
+#if CONFIG_OTA_BACKGROUND_MAX_SPEED_KB > 0
+            // 后台下载时限制平均速度，给对话和其他网络请求留出带宽
+            if (background_upgrade_) {
+                int64_t expected_us = (int64_t)(total_read - resume_offset) * 1000000 / (CONFIG_OTA_BACKGROUND_MAX_SPEED_KB * 1024);
+                int64_t elapsed_us = esp_timer_get_time() - start_time;
+                if (expected_us - elapsed_us >= 10000) {
+                    vTaskDelay(pdMS_TO_TICKS((expected_us - elapsed_us) / 1000));
+                }
+            }
+#endif
 
-                auto current_version = esp_app_get_description()->version;
-                if (memcmp(new_app_info.version, current_version, sizeof(new_app_info.version)) == 0) {
-                    ESP_LOGE(TAG, "Firmware version is the same, skipping upgrade");
-                    return;
+            // Calculate speed and progress every second, the speed is smoothed over several seconds
+            auto now = esp_timer_get_time();
+            if (now - last_calc_time >= 1000000) {
+                size_t recent_speed = recent_read * 1000000LL / (now - last_calc_time);
+                speed = speed == 0 ? recent_speed : (speed * 3 + recent_speed) / 4;
+                size_t progress = total_read * 100 / content_length;
+                ESP_LOGI(TAG, "Progress: %u%% (%u/%u), Speed: %uB/s, Written: %u", progress, total_read, content_length,
+                    speed, (size_t)writer.written);
+                if (upgrade_callback_) {
+                    upgrade_callback_(progress, speed);
                 }
+                last_calc_time = now;
+                recent_read = 0;
+            }
 
-                if (esp_ota_begin(update_partition, OTA_WITH_SEQUENTIAL_WRITES, &update_handle)) {
-                    esp_ota_abort(update_handle);
-                    ESP_LOGE(TAG, "Failed to begin OTA");
-                    return;
+            if (background_upgrade_ && upgrade_paused_) {
+                // 可以续传时断开，恢复后从断点继续；补丁和压缩固件只能从头开始，不断开而是限速
+                if (writer.IsResumable()) {
+                    break;
                 }
+                vTaskDelay(pdMS_TO_TICKS(ret * 1000 / (OTA_PAUSED_MAX_SPEED_KB * 1024)));
+            }
+        }
+        if (ret < 0) {
+            ESP_LOGE(TAG, "Failed to read HTTP data: %s", esp_err_to_name(ret));
+            xQueueSend(writer.free_chunks, &chunk, 0);
+            break;
+        }
 
-                image_header_checked = true;
-                std::string().swap(image_header);
+        // 第一块数据到达后再开始 OTA 和写入任务，压缩的固件或补丁在写入任务中解压
+        if (writer_task == nullptr) {
+            if (resume_offset == 0 && chunk->size >= sizeof(OtaCompressedHeader)
+                && memcmp(chunk->data, OTA_COMPRESSED_MAGIC, strlen(OTA_COMPRESSED_MAGIC)) == 0) {
+                decompressor = std::make_unique<OtaDecompressor>([&writer](const uint8_t* data, size_t size) {
+                    return writer.patcher != nullptr ? writer.patcher->Feed(data, size) : writer.Write(data, size);
+                });
+                writer.decompressor = decompressor.get();
+            }
+            // 使用顺序写入模式，esp_ota_begin 不会擦除分区，续传时之前写入的数据得以保留
+            if (esp_ota_begin(update_partition, OTA_WITH_SEQUENTIAL_WRITES, &writer.handle)) {
+                esp_ota_abort(writer.handle);
+                ESP_LOGE(TAG, "Failed to begin OTA");
+                xQueueSend(writer.free_chunks, &chunk, 0);
+                break;
+            }
+            if (is_patch) {
+                // 分区内容将被补丁覆盖，之前保存的续传进度不再有效
+                ClearResumeState();
+            } else if (resume_offset == 0 && writer.IsResumable()) {
+                Settings settings("ota", true);
+                settings.SetString("url", firmware_url);
+                settings.SetString("version", version);
+                settings.SetString("partition", update_partition->label);
+                settings.SetString("etag", etag);
+                settings.SetInt("total", content_length);
+                settings.SetInt("written", 0);
             }
+            xTaskCreate([](void* arg) {
+                auto writer = static_cast<OtaWriter*>(arg);
+                writer->Run();
+                vTaskDelete(NULL);
+            }, "ota_writer", 4096, &writer, uxTaskPriorityGet(NULL) + 1, &writer_task);
         }
-        auto err = esp_ota_write(update_handle, buffer, ret);
-        if (err != ESP_OK) {
-            ESP_LOGE(TAG, "Failed to write OTA data: %s", esp_err_to_name(err));
-            esp_ota_abort(update_handle);
-            return;
+
+        if (chunk->size > 0) {
+            xQueueSend(writer.full_chunks, &chunk, portMAX_DELAY);
+        } else {
+            xQueueSend(writer.free_chunks, &chunk, 0);
+        }
+        if (ret == 0) {
+            success = total_read == content_length;
+            if (!success) {
+                ESP_LOGE(TAG, "Connection closed at %u/%u", total_read, content_length);
+            }
+            break;
+        }
+        // 已接收的数据照常写入并保存进度，恢复后从断点继续
+        if (background_upgrade_ && upgrade_paused_ && writer.IsResumable()) {
+            ESP_LOGI(TAG, "Download paused at %u/%u", total_read, content_length);
+            break;
         }
     }
     http->Close();
 
-    esp_err_t err = esp_ota_end(update_handle);
+    // 通知写入任务结束，并等待已接收的数据全部写入
+    if (writer_task != nullptr) {
+        OtaChunk* end = nullptr;
+        xQueueSend(writer.full_chunks, &end, portMAX_DELAY);
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+    vQueueDelete(writer.free_chunks);
+    vQueueDelete(writer.full_chunks);
+    for (auto& chunk : chunks) {
+        heap_caps_free(chunk.data);
+    }
+    if (writer_task == nullptr) {
+        return false;
+    }
+
+    int64_t elapsed_ms = (esp_timer_get_time() - start_time) / 1000;
+    size_t downloaded = total_read - resume_offset;
+    ESP_LOGI(TAG, "OTA downloaded %u bytes, wrote %u bytes in %d ms (%u B/s), network waited %d ms, flash waited %d ms, erase %d ms, write %d ms",
+        downloaded, (size_t)writer.written - resume_offset, (int)elapsed_ms, (size_t)(elapsed_ms > 0 ? downloaded * 1000 / elapsed_ms : 0),
+        (int)(network_wait_us / 1000), (int)(writer.wait_us / 1000), (int)(writer.erase_us / 1000), (int)(writer.write_us / 1000));
+    if (decompressor != nullptr && decompressor->input_size() > 0) {
+        int64_t decompress_ms = decompressor->decompress_time_us() / 1000;
+        ESP_LOGI(TAG, "Decompressed %u -> %u bytes (%u%%) in %d ms (%u KB/s)",
+            decompressor->input_size(), decompressor->output_size(),
+            decompressor->input_size() * 100 / std::max<size_t>(decompressor->output_size(), 1), (int)decompress_ms,
+            (size_t)(decompress_ms > 0 ? decompressor->output_size() / decompress_ms : 0));
+    }
+
+    // 网络错误时保留进度，下次从断点继续
+    if (!success || writer.result != ESP_OK) {
+        esp_ota_abort(writer.handle);
+        if (writer.result != ESP_OK) {
+            ClearResumeState();
+        }
+        return false;
+    }
+
+    // 续传的固件同样校验整个镜像的 SHA-256
+    // 不经过句柄写入的数据不计入句柄，esp_ota_end 会拒绝，改为直接校验分区
+    esp_err_t err;
+    if (writer.sequential) {
+        err = esp_ota_end(writer.handle);
+    } else {
+        esp_ota_abort(writer.handle);
+        err = VerifyImage(update_partition);
+    }
+    ClearResumeState();
     if (err != ESP_OK) {
         if (err == ESP_ERR_OTA_VALIDATE_FAILED) {
             ESP_LOGE(TAG, "Image validation failed, image is corrupted");
         } else {
             ESP_LOGE(TAG, "Failed to end OTA: %s", esp_err_to_name(err));
         }
-        return;
+        return false;
     }
 
     err = esp_ota_set_boot_partition(update_partition);
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "Failed to set boot partition: %s", esp_err_to_name(err));
-        return;
+        return false;
     }
 
+    if (upgrade_callback_) {
+        upgrade_callback_(100, speed);
+    }
+    if (background_upgrade_) {
+        ESP_LOGI(TAG, "Firmware downloaded, it will be activated on the next reboot");
+        return true;
+    }
     ESP_LOGI(TAG, "Firmware upgrade successful, rebooting in 3 seconds...");
     vTaskDelay(pdMS_TO_TICKS(3000));
     esp_restart();
@@ -352,7 +734,43 @@ void Ota::Upgrade(const std::string& firmware_url) {
 
 void Ota::StartUpgrade(std::function<void(int progress, size_t speed)> callback) {
     upgrade_callback_ = callback;
-    Upgrade(firmware_url_);
+    // 升级成功后会直接重启，补丁升级失败时下载完整固件
+    if (!patch_url_.empty()) {
+        Upgrade(patch_url_, firmware_version_, true);
+        ESP_LOGW(TAG, "Patch upgrade failed, downloading the full firmware");
+    }
+    Upgrade(firmware_url_, firmware_version_, false);
+}
+
+bool Ota::DownloadUpgrade(const OtaTarget& target, std::function<void(int progress, size_t speed)> callback) {
+    upgrade_callback_ = callback;
+    background_upgrade_ = true;
+    bool use_patch = !target.patch_url.empty();
+    int retry_count = 0;
+    while (true) {
+        while (upgrade_paused_) {
+            vTaskDelay(pdMS_TO_TICKS(1000));
+        }
+        if (Upgrade(use_patch ? target.patch_url : target.firmware_url, target.version, use_patch)) {
+            upgrade_pending_ = true;
+            return true;
+        }
+        if (upgrade_paused_) {
+            continue;
+        }
+        if (use_patch) {
+            ESP_LOGW(TAG, "Patch upgrade failed, downloading the full firmware");
+            use_patch = false;
+            continue;
+        }
+        retry_count++;
+        if (retry_count >= OTA_BACKGROUND_MAX_RETRY) {
+            ESP_LOGE(TAG, "Too many retries, give up background upgrade");
+            return false;
+        }
+        ESP_LOGW(TAG, "Background upgrade failed, retry in %d seconds (%d/%d)", retry_count * 10, retry_count, OTA_BACKGROUND_MAX_RETRY);
+        vTaskDelay(pdMS_TO_TICKS(retry_count * 10000));
+    }
 }
 
 std::vector<int> Ota::ParseVersion(const std::string& version) {
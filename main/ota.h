@@ -3,10 +3,33 @@
 
 #include <functional>
 #include <string>
+#include <atomic>
 
 #include <esp_err.h>
 #include "board.h"
 
+// OTA 下载与写入流水线的数据块数量，一个任务接收 HTTP 数据的同时另一个任务写入 flash
+#define OTA_CHUNK_COUNT 2
+// 每写入这么多字节保存一次进度到 NVS，用于断点续传
+#define OTA_RESUME_SAVE_INTERVAL (64 * 1024)
+// 后台下载连续失败的最大次数，暂停导致的中断不计入
+#define OTA_BACKGROUND_MAX_RETRY 5
+
+// 对话期间不能续传的后台下载（补丁、压缩固件、flash 加密）不断开连接，限速到该值（KB/s）
+#define OTA_PAUSED_MAX_SPEED_KB 4
+
+struct OtaChunk {
+    uint8_t* data;
+    size_t size;
+};
+
+// 后台下载使用的版本和地址的副本，下载期间 CheckVersion 可能在其他任务中更新 Ota 的成员
+struct OtaTarget {
+    std::string version;
+    std::string firmware_url;
+    std::string patch_url;
+};
+
 class Ota {
 public:
     Ota();
@@ -21,6 +44,13 @@ public:
     bool HasActivationCode() { return has_activation_code_; }
     bool HasServerTime() { return has_server_time_; }
     void StartUpgrade(std::function<void(int progress, size_t speed)> callback);
+    // 在调用 CheckVersion 的任务中取得副本，再交给后台下载任务
+    OtaTarget GetUpgradeTarget() const { return {firmware_version_, firmware_url_, patch_url_}; }
+    // 在后台限速下载新固件，完成后设置启动分区但不重启，新固件在下次重启时生效
+    bool DownloadUpgrade(const OtaTarget& target, std::function<void(int progress, size_t speed)> callback);
+    // 暂停时断开下载连接，恢复后从断点继续；不能续传的下载不断开，只降低速度
+    void PauseUpgrade(bool paused) { upgrade_paused_ = paused; }
+    bool IsUpgradePending() { return upgrade_pending_; }
     void MarkCurrentVersionValid();
 
     const std::string& GetFirmwareVersion() const { return firmware_version_; }
@@ -42,11 +72,15 @@ private:
     std::string current_version_;
     std::string firmware_version_;
     std::string firmware_url_;
+    std::string patch_url_;
     std::string activation_challenge_;
     std::string serial_number_;
     int activation_timeout_ms_ = 30000;
+    bool background_upgrade_ = false;
+    std::atomic<bool> upgrade_paused_ = false;
+    std::atomic<bool> upgrade_pending_ = false;
 
-    void Upgrade(const std::string& firmware_url);
+    bool Upgrade(const std::string& firmware_url, const std::string& version, bool is_patch);
     std::function<void(int progress, size_t speed)> upgrade_callback_;
     std::vector<int> ParseVersion(const std::string& version);
     bool IsNewVersionAvailable(const std::string& currentVersion, const std::string& newVersion);
@@ -0,0 +1,133 @@
+#include "ota_decompressor.h"
+
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <cstring>
+#include <algorithm>
+#if __has_include(<rom/miniz.h>)
+#include <rom/miniz.h>
+#define OTA_HAS_ROM_MINIZ 1
+#endif
+
+#define TAG "OtaDecompressor"
+
+OtaDecompressor::OtaDecompressor(std::function<esp_err_t(const uint8_t* data, size_t size)> output)
+    : output_(output) {
+}
+
+OtaDecompressor::~OtaDecompressor() {
+#ifdef OTA_HAS_ROM_MINIZ
+    delete static_cast<tinfl_decompressor*>(inflator_);
+#endif
+    delete[] window_;
+}
+
+esp_err_t OtaDecompressor::Feed(const uint8_t* data, size_t size) {
+    input_size_ += size;
+    if (header_size_ < sizeof(header_)) {
+        size_t n = std::min(size, sizeof(header_) - header_size_);
+        memcpy((uint8_t*)&header_ + header_size_, data, n);
+        header_size_ += n;
+        data += n;
+        size -= n;
+        if (header_size_ < sizeof(header_)) {
+            return ESP_OK;
+        }
+        esp_err_t err = CheckHeader();
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+    if (done_ || size == 0) {
+        return ESP_OK;
+    }
+    return Inflate(data, size, true);
+}
+
+esp_err_t OtaDecompressor::Finish() {
+    if (header_size_ < sizeof(header_)) {
+        ESP_LOGE(TAG, "Compressed image is incomplete");
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (!done_) {
+        esp_err_t err = Inflate(nullptr, 0, false);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+    if (output_size_ != header_.original_size) {
+        ESP_LOGE(TAG, "Decompressed %u bytes, expected %lu", output_size_, header_.original_size);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    return ESP_OK;
+}
+
+esp_err_t OtaDecompressor::CheckHeader() {
+    if (memcmp(header_.magic, OTA_COMPRESSED_MAGIC, sizeof(header_.magic)) != 0) {
+        ESP_LOGE(TAG, "Invalid compressed image magic");
+        return ESP_ERR_INVALID_ARG;
+    }
+#ifdef OTA_HAS_ROM_MINIZ
+    // 解压只需要与压缩时相同大小的环形窗口，以及 tinfl 的解码表
+    if (header_.window_bits < 8 || header_.window_bits > CONFIG_OTA_DECOMPRESS_MAX_WINDOW_BITS) {
+        ESP_LOGE(TAG, "Window bits %lu not supported, max %d", header_.window_bits, CONFIG_OTA_DECOMPRESS_MAX_WINDOW_BITS);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    window_size_ = 1 << header_.window_bits;
+    window_ = new uint8_t[window_size_];
+    auto inflator = new tinfl_decompressor;
+    tinfl_init(inflator);
+    inflator_ = inflator;
+    ESP_LOGI(TAG, "Decompressing image, %lu bytes, window %u bytes, %u bytes of state",
+        header_.original_size, window_size_, sizeof(tinfl_decompressor));
+    return ESP_OK;
+#else
+    ESP_LOGE(TAG, "Compressed images are not supported on this chip");
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+esp_err_t OtaDecompressor::Inflate(const uint8_t* data, size_t size, bool has_more_input) {
+#ifdef OTA_HAS_ROM_MINIZ
+    auto inflator = static_cast<tinfl_decompressor*>(inflator_);
+    static const uint8_t empty = 0;
+    if (data == nullptr) {
+        data = &empty;
+    }
+    while (true) {
+        size_t in_size = size;
+        size_t out_size = window_size_ - window_pos_;
+        auto start_time = esp_timer_get_time();
+        auto status = tinfl_decompress(inflator, data, &in_size, window_, window_ + window_pos_, &out_size,
+            has_more_input ? TINFL_FLAG_HAS_MORE_INPUT : 0);
+        decompress_time_us_ += esp_timer_get_time() - start_time;
+        data += in_size;
+        size -= in_size;
+
+        if (out_size > 0) {
+            output_size_ += out_size;
+            if (output_size_ > header_.original_size) {
+                ESP_LOGE(TAG, "Decompressed data exceeds %lu bytes", header_.original_size);
+                return ESP_ERR_INVALID_SIZE;
+            }
+            esp_err_t err = output_(window_ + window_pos_, out_size);
+            if (err != ESP_OK) {
+                return err;
+            }
+            window_pos_ = (window_pos_ + out_size) & (window_size_ - 1);
+        }
+
+        if (status == TINFL_STATUS_DONE) {
+            done_ = true;
+            return ESP_OK;
+        } else if (status == TINFL_STATUS_NEEDS_MORE_INPUT && has_more_input) {
+            return ESP_OK;
+        } else if (status != TINFL_STATUS_HAS_MORE_OUTPUT) {
+            ESP_LOGE(TAG, "Failed to decompress, status %d", (int)status);
+            return ESP_ERR_INVALID_RESPONSE;
+        }
+    }
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
@@ -0,0 +1,52 @@
+#ifndef _OTA_DECOMPRESSOR_H
+#define _OTA_DECOMPRESSOR_H
+
+#include <functional>
+#include <cstdint>
+
+#include <esp_err.h>
+
+// 压缩固件格式，由 scripts/compress_firmware.py 生成，所有字段均为小端
+// 文件头之后是窗口不超过 2^window_bits 字节的 raw deflate 数据流，使用 ROM 中的 tinfl 边下载边解压
+#define OTA_COMPRESSED_MAGIC "XZDEFL01"
+
+struct OtaCompressedHeader {
+    char magic[8];
+    uint32_t window_bits;
+    uint32_t original_size;     // 解压后固件的大小
+};
+
+class OtaDecompressor {
+public:
+    OtaDecompressor(std::function<esp_err_t(const uint8_t* data, size_t size)> output);
+    ~OtaDecompressor();
+
+    // 按顺序传入下载的压缩数据，解压出的数据按顺序交给 output
+    esp_err_t Feed(const uint8_t* data, size_t size);
+    // 压缩数据全部传入后调用，检查数据流是否完整
+    esp_err_t Finish();
+
+    size_t input_size() const { return input_size_; }
+    size_t output_size() const { return output_size_; }
+    int64_t decompress_time_us() const { return decompress_time_us_; }
+
+private:
+    std::function<esp_err_t(const uint8_t* data, size_t size)> output_;
+    OtaCompressedHeader header_;
+    size_t header_size_ = 0;
+    bool done_ = false;
+
+    void* inflator_ = nullptr;
+    uint8_t* window_ = nullptr;
+    size_t window_size_ = 0;
+    size_t window_pos_ = 0;
+
+    size_t input_size_ = 0;
+    size_t output_size_ = 0;
+    int64_t decompress_time_us_ = 0;
+
+    esp_err_t CheckHeader();
+    esp_err_t Inflate(const uint8_t* data, size_t size, bool has_more_input);
+};
+
+#endif // _OTA_DECOMPRESSOR_H
@@ -0,0 +1,154 @@
+#include "ota_patch.h"
+
+#include <esp_log.h>
+#include <cstring>
+#include <algorithm>
+
+#define TAG "OtaPatcher"
+
+OtaPatcher::OtaPatcher(const esp_partition_t* base, std::function<esp_err_t(const uint8_t* data, size_t size)> output)
+    : base_(base), output_(output) {
+    base_buffer_ = new uint8_t[OTA_PATCH_BASE_BUFFER_SIZE];
+    output_buffer_ = new uint8_t[OTA_PATCH_OUTPUT_BUFFER_SIZE];
+}
+
+OtaPatcher::~OtaPatcher() {
+    delete[] base_buffer_;
+    delete[] output_buffer_;
+}
+
+esp_err_t OtaPatcher::Feed(const uint8_t* data, size_t size) {
+    while (size > 0) {
+        esp_err_t err = ESP_OK;
+        size_t consumed = 0;
+        if (state_ == kStateHeader || state_ == kStateControl) {
+            auto field = state_ == kStateHeader ? (uint8_t*)&header_ : (uint8_t*)&control_;
+            size_t field_size = state_ == kStateHeader ? sizeof(header_) : sizeof(control_);
+            consumed = std::min(size, field_size - field_size_);
+            memcpy(field + field_size_, data, consumed);
+            field_size_ += consumed;
+            if (field_size_ == field_size) {
+                field_size_ = 0;
+                if (state_ == kStateHeader) {
+                    err = CheckHeader();
+                } else if ((uint64_t)control_.diff_size + control_.extra_size > header_.target_size - target_offset_) {
+                    ESP_LOGE(TAG, "Control block exceeds target size at %u", target_offset_);
+                    err = ESP_ERR_INVALID_SIZE;
+                } else {
+                    state_ = kStateDiff;
+                    remaining_ = control_.diff_size;
+                }
+            }
+        } else {
+            consumed = std::min(size, remaining_);
+            err = state_ == kStateDiff ? ApplyDiff(data, consumed) : Output(data, consumed);
+            remaining_ -= consumed;
+        }
+        if (err != ESP_OK) {
+            return err;
+        }
+        data += consumed;
+        size -= consumed;
+
+        // diff 和 extra 数据都可能为空，结束后直接进入下一个状态
+        if (state_ == kStateDiff && remaining_ == 0) {
+            state_ = kStateExtra;
+            remaining_ = control_.extra_size;
+        }
+        if (state_ == kStateExtra && remaining_ == 0) {
+            state_ = kStateControl;
+            base_offset_ += control_.seek;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t OtaPatcher::Finish() {
+    if (state_ != kStateControl || field_size_ != 0 || target_offset_ != header_.target_size) {
+        ESP_LOGE(TAG, "Patch is incomplete, %u/%u bytes restored", target_offset_,
+            state_ == kStateHeader ? 0 : (unsigned)header_.target_size);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    return FlushOutput();
+}
+
+// 补丁必须基于当前运行的固件生成，用镜像末尾附加的 SHA-256 确认
+esp_err_t OtaPatcher::CheckHeader() {
+    if (memcmp(header_.magic, OTA_PATCH_MAGIC, sizeof(header_.magic)) != 0) {
+        ESP_LOGE(TAG, "Invalid patch magic");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (header_.base_size > base_->size) {
+        ESP_LOGE(TAG, "Base size %lu exceeds partition %s", header_.base_size, base_->label);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    uint8_t sha256[32];
+    esp_err_t err = esp_partition_get_sha256(base_, sha256);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to get SHA-256 of %s: %s", base_->label, esp_err_to_name(err));
+        return err;
+    }
+    if (memcmp(sha256, header_.base_sha256, sizeof(sha256)) != 0) {
+        ESP_LOGE(TAG, "Patch was not made for the running firmware");
+        return ESP_ERR_INVALID_VERSION;
+    }
+
+    ESP_LOGI(TAG, "Applying patch, base %lu bytes, target %lu bytes", header_.base_size, header_.target_size);
+    state_ = kStateControl;
+    return ESP_OK;
+}
+
+// 新数据 = 旧固件对应位置的数据 + diff 数据（按字节相加）
+esp_err_t OtaPatcher::ApplyDiff(const uint8_t* data, size_t size) {
+    while (size > 0) {
+        if (base_offset_ < 0 || base_offset_ >= header_.base_size) {
+            ESP_LOGE(TAG, "Base offset %lld out of range", base_offset_);
+            return ESP_ERR_INVALID_SIZE;
+        }
+        size_t n = std::min<size_t>({size, OTA_PATCH_BASE_BUFFER_SIZE, (size_t)(header_.base_size - base_offset_)});
+        esp_err_t err = esp_partition_read(base_, base_offset_, base_buffer_, n);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to read base firmware: %s", esp_err_to_name(err));
+            return err;
+        }
+        for (size_t i = 0; i < n; i++) {
+            base_buffer_[i] += data[i];
+        }
+        err = Output(base_buffer_, n);
+        if (err != ESP_OK) {
+            return err;
+        }
+        base_offset_ += n;
+        data += n;
+        size -= n;
+    }
+    return ESP_OK;
+}
+
+esp_err_t OtaPatcher::Output(const uint8_t* data, size_t size) {
+    target_offset_ += size;
+    while (size > 0) {
+        size_t n = std::min(size, OTA_PATCH_OUTPUT_BUFFER_SIZE - output_size_);
+        memcpy(output_buffer_ + output_size_, data, n);
+        output_size_ += n;
+        data += n;
+        size -= n;
+        if (output_size_ == OTA_PATCH_OUTPUT_BUFFER_SIZE) {
+            esp_err_t err = FlushOutput();
+            if (err != ESP_OK) {
+                return err;
+            }
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t OtaPatcher::FlushOutput() {
+    if (output_size_ == 0) {
+        return ESP_OK;
+    }
+    esp_err_t err = output_(output_buffer_, output_size_);
+    output_size_ = 0;
+    return err;
+}
@@ -0,0 +1,70 @@
+#ifndef _OTA_PATCH_H
+#define _OTA_PATCH_H
+
+#include <functional>
+#include <cstdint>
+
+#include <esp_err.h>
+#include <esp_partition.h>
+
+// 差分补丁格式，由 scripts/gen_patch.py 生成，所有字段均为小端
+// 文件头之后是若干个 bsdiff 控制块，每个控制块后面紧跟着它的 diff 数据和 extra 数据，
+// 因此可以边下载边还原，只需要固定大小的缓冲区
+#define OTA_PATCH_MAGIC "XZPATCH1"
+#define OTA_PATCH_BASE_BUFFER_SIZE 1024
+#define OTA_PATCH_OUTPUT_BUFFER_SIZE 4096
+
+struct OtaPatchHeader {
+    char magic[8];
+    uint32_t base_size;         // 旧固件镜像的大小
+    uint32_t target_size;       // 新固件镜像的大小
+    uint8_t base_sha256[32];    // 旧固件镜像末尾附加的 SHA-256
+};
+
+struct OtaPatchControl {
+    uint32_t diff_size;         // 与旧固件逐字节相加的长度
+    uint32_t extra_size;        // 直接写入的长度
+    int32_t seek;               // 之后旧固件读取位置的偏移
+};
+
+// 以正在运行的分区为基准还原新固件，还原出的数据按顺序交给 output，可以直接用于顺序写入
+class OtaPatcher {
+public:
+    OtaPatcher(const esp_partition_t* base, std::function<esp_err_t(const uint8_t* data, size_t size)> output);
+    ~OtaPatcher();
+
+    // 按顺序传入下载的补丁数据
+    esp_err_t Feed(const uint8_t* data, size_t size);
+    // 补丁数据全部传入后调用，检查补丁是否完整
+    esp_err_t Finish();
+
+private:
+    enum State {
+        kStateHeader,
+        kStateControl,
+        kStateDiff,
+        kStateExtra,
+    };
+
+    const esp_partition_t* base_;
+    std::function<esp_err_t(const uint8_t* data, size_t size)> output_;
+    State state_ = kStateHeader;
+
+    OtaPatchHeader header_;
+    OtaPatchControl control_;
+    size_t field_size_ = 0;     // 文件头或控制块已接收的字节数
+    size_t remaining_ = 0;      // 当前 diff 或 extra 数据剩余的字节数
+    int64_t base_offset_ = 0;
+    size_t target_offset_ = 0;
+
+    uint8_t* base_buffer_ = nullptr;
+    uint8_t* output_buffer_ = nullptr;
+    size_t output_size_ = 0;
+
+    esp_err_t CheckHeader();
+    esp_err_t ApplyDiff(const uint8_t* data, size_t size);
+    esp_err_t Output(const uint8_t* data, size_t size);
+    esp_err_t FlushOutput();
+};
+
+#endif // _OTA_PATCH_H
@@ -115,6 +115,30 @@ void Protocol::SendIotStates(const std::string& states) {
     SendText(message);
 }
 
+bool Protocol::SendImage(const ImageStreamPacket& packet) {
+    if (packet.type == kImagePacketData) {
+        return SendImageData(packet);
+    }
+
+    cJSON* root = cJSON_CreateObject();
+    cJSON_AddStringToObject(root, "session_id", session_id_.c_str());
+    cJSON_AddStringToObject(root, "type", "image");
+    cJSON_AddNumberToObject(root, "id", packet.image_id);
+    if (packet.type == kImagePacketStart) {
+        cJSON_AddStringToObject(root, "state", "start");
+        cJSON_AddStringToObject(root, "format", "jpeg");
+        cJSON_AddStringToObject(root, "question", packet.question.c_str());
+    } else {
+        cJSON_AddStringToObject(root, "state", "end");
+        cJSON_AddNumberToObject(root, "size", packet.size);
+    }
+    auto json_str = cJSON_PrintUnformatted(root);
+    std::string message(json_str);
+    cJSON_free(json_str);
+    cJSON_Delete(root);
+    return SendText(message);
+}
+
 void Protocol::SendMcpMessage(const std::string& payload) {
     std::string message = "{\"session_id\":\"" + session_id_ + "\",\"type\":\"mcp\",\"payload\":" + payload + "}";
     SendText(message);
@@ -12,9 +12,24 @@ struct AudioStreamPacket {
     std::vector<uint8_t> payload;
 };
 
+enum ImagePacketType {
+    kImagePacketStart,
+    kImagePacketData,
+    kImagePacketEnd
+};
+
+// A JPEG image streamed over the audio channel: a start message, the data chunks and an end message
+struct ImageStreamPacket {
+    ImagePacketType type = kImagePacketData;
+    uint32_t image_id = 0;
+    std::string question;           // kImagePacketStart only
+    std::vector<uint8_t> payload;   // kImagePacketData only
+    size_t size = 0;                // kImagePacketEnd only, total size of the image
+};
+
 struct BinaryProtocol2 {
     uint16_t version;
-    uint16_t type;          // Message type (0: OPUS, 1: JSON)
+    uint16_t type;          // Message type (0: OPUS, 1: JSON, 2: IMAGE)
     uint32_t reserved;      // Reserved for future use
     uint32_t timestamp;     // Timestamp in milliseconds (used for server-side AEC)
     uint32_t payload_size;  // Payload size in bytes
@@ -64,6 +79,8 @@ public:
     virtual void CloseAudioChannel() = 0;
     virtual bool IsAudioChannelOpened() const = 0;
     virtual bool SendAudio(const AudioStreamPacket& packet) = 0;
+    virtual bool SupportsImage() const { return false; }
+    bool SendImage(const ImageStreamPacket& packet);
     virtual void SendWakeWordDetected(const std::string& wake_word);
     virtual void SendStartListening(ListeningMode mode);
     virtual void SendStopListening();
@@ -86,6 +103,7 @@ protected:
     std::chrono::time_point<std::chrono::steady_clock> last_incoming_time_;
 
     virtual bool SendText(const std::string& text) = 0;
+    virtual bool SendImageData(const ImageStreamPacket& packet) { return false; }
     virtual void SetError(const std::string& message);
     virtual bool IsTimeout() const;
 };
@@ -3,6 +3,7 @@
 #include "system_info.h"
 #include "application.h"
 #include "settings.h"
+#include "heap_tag.h"
 
 #include <cstring>
 #include <cJSON.h>
@@ -60,6 +61,46 @@ bool WebsocketProtocol::SendAudio(const AudioStreamPacket& packet) {
     }
 }
 
+// Version 1 sends raw OPUS frames without a header, so images can not be told apart from audio
+bool WebsocketProtocol::SupportsImage() const {
+#if CONFIG_CAMERA_EXPLAIN_OVER_AUDIO_CHANNEL
+    return version_ == 2 || version_ == 3;
+#else
+    return false;
+#endif
+}
+
+bool WebsocketProtocol::SendImageData(const ImageStreamPacket& packet) {
+    if (websocket_ == nullptr) {
+        return false;
+    }
+
+    std::string serialized;
+    if (version_ == 2) {
+        serialized.resize(sizeof(BinaryProtocol2) + packet.payload.size());
+        auto bp2 = (BinaryProtocol2*)serialized.data();
+        bp2->version = htons(version_);
+        bp2->type = htons(2);
+        bp2->reserved = htonl(packet.image_id);  // The reserved field carries the image id
+        bp2->timestamp = 0;
+        bp2->payload_size = htonl(packet.payload.size());
+        memcpy(bp2->payload, packet.payload.data(), packet.payload.size());
+    } else if (version_ == 3) {
+        // Version 3 has no room in the header, the image id is sent as a 4-byte big endian prefix of the payload
+        uint32_t image_id = htonl(packet.image_id);
+        serialized.resize(sizeof(BinaryProtocol3) + sizeof(image_id) + packet.payload.size());
+        auto bp3 = (BinaryProtocol3*)serialized.data();
+        bp3->type = 2;
+        bp3->reserved = 0;
+        bp3->payload_size = htons(sizeof(image_id) + packet.payload.size());
+        memcpy(bp3->payload, &image_id, sizeof(image_id));
+        memcpy(bp3->payload + sizeof(image_id), packet.payload.data(), packet.payload.size());
+    } else {
+        return false;
+    }
+    return websocket_->Send(serialized.data(), serialized.size(), true);
+}
+
 bool WebsocketProtocol::SendText(const std::string& text) {
     if (websocket_ == nullptr) {
         return false;
@@ -86,6 +127,7 @@ void WebsocketProtocol::CloseAudioChannel() {
 }
 
 bool WebsocketProtocol::OpenAudioChannel() {
+    HeapTagScope heap_tag_scope(kHeapTagProtocol);
     if (websocket_ != nullptr) {
         delete websocket_;
     }
@@ -210,6 +252,9 @@ std::string WebsocketProtocol::GetHelloMessage() {
 #if CONFIG_IOT_PROTOCOL_MCP
     cJSON_AddBoolToObject(features, "mcp", true);
 #endif
+    if (SupportsImage()) {
+        cJSON_AddBoolToObject(features, "image", true);
+    }
     cJSON_AddItemToObject(root, "features", features);
     cJSON_AddStringToObject(root, "transport", "websocket");
     cJSON* audio_params = cJSON_CreateObject();
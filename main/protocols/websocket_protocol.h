@@ -20,6 +20,7 @@ public:
     bool OpenAudioChannel() override;
     void CloseAudioChannel() override;
     bool IsAudioChannelOpened() const override;
+    bool SupportsImage() const override;
 
 private:
     EventGroupHandle_t event_group_handle_;
@@ -28,6 +29,7 @@ private:
 
     void ParseServerHello(const cJSON* root);
     bool SendText(const std::string& text) override;
+    bool SendImageData(const ImageStreamPacket& packet) override;
     std::string GetHelloMessage();
 };
 
@@ -1,45 +1,252 @@
 #include "settings.h"
 
 #include <esp_log.h>
+#include <esp_timer.h>
+#include <esp_system.h>
 #include <nvs_flash.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include <map>
+#include <mutex>
 
 #define TAG "Settings"
 
-Settings::Settings(const std::string& ns, bool read_write) : ns_(ns), read_write_(read_write) {
-    nvs_open(ns.c_str(), read_write_ ? NVS_READWRITE : NVS_READONLY, &nvs_handle_);
+struct SettingsValue {
+    bool is_int = false;
+    int32_t int_value = 0;
+    std::string str_value;
+    bool dirty = false;
+    bool erased = false;
+};
+
+struct SettingsNamespace {
+    std::map<std::string, SettingsValue> values;
+    bool erase_all = false;     // 提交时先清空整个命名空间
+    bool dirty = false;
+};
+
+class SettingsCache {
+public:
+    static SettingsCache& GetInstance() {
+        static SettingsCache instance;
+        return instance;
+    }
+
+    std::mutex mutex_;
+
+    // 第一次访问命名空间时读出其中所有的整数和字符串，调用前需持有 mutex_
+    SettingsNamespace& Load(const std::string& ns);
+    // 调用前需持有 mutex_
+    void MarkDirty(SettingsNamespace& ns);
+    void ScheduleFlush();
+    void Flush();
+    void Clear();
+
+private:
+    SettingsCache();
+
+    std::map<std::string, SettingsNamespace> namespaces_;
+    esp_timer_handle_t flush_timer_ = nullptr;
+    // 写 flash 较慢，放在单独的低优先级任务中，不占用共享的 esp_timer 任务
+    TaskHandle_t flush_task_ = nullptr;
+    int64_t first_dirty_us_ = 0;
+};
+
+SettingsCache::SettingsCache() {
+    esp_timer_create_args_t timer_args = {
+        .callback = [](void* arg) {
+            xTaskNotifyGive(static_cast<SettingsCache*>(arg)->flush_task_);
+        },
+        .arg = this,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "settings_flush",
+        .skip_unhandled_events = true
+    };
+    esp_timer_create(&timer_args, &flush_timer_);
+
+    xTaskCreate([](void* arg) {
+        auto cache = static_cast<SettingsCache*>(arg);
+        while (true) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            cache->Flush();
+        }
+    }, "settings_flush", 4096, this, 1, &flush_task_);
+
+    // esp_restart 之前提交未写入的修改
+    esp_register_shutdown_handler([]() {
+        SettingsCache::GetInstance().Flush();
+    });
 }
 
-Settings::~Settings() {
-    if (nvs_handle_ != 0) {
-        if (read_write_ && dirty_) {
-            ESP_ERROR_CHECK(nvs_commit(nvs_handle_));
+SettingsNamespace& SettingsCache::Load(const std::string& ns) {
+    auto it = namespaces_.find(ns);
+    if (it != namespaces_.end()) {
+        return it->second;
+    }
+
+    auto& loaded = namespaces_[ns];
+    nvs_handle_t handle = 0;
+    if (nvs_open(ns.c_str(), NVS_READONLY, &handle) != ESP_OK) {
+        return loaded;
+    }
+    nvs_iterator_t entry = nullptr;
+    esp_err_t err = nvs_entry_find(NVS_DEFAULT_PART_NAME, ns.c_str(), NVS_TYPE_ANY, &entry);
+    while (err == ESP_OK) {
+        nvs_entry_info_t info;
+        nvs_entry_info(entry, &info);
+        if (info.type == NVS_TYPE_I32) {
+            SettingsValue value;
+            value.is_int = true;
+            if (nvs_get_i32(handle, info.key, &value.int_value) == ESP_OK) {
+                loaded.values[info.key] = std::move(value);
+            }
+        } else if (info.type == NVS_TYPE_STR) {
+            size_t length = 0;
+            if (nvs_get_str(handle, info.key, nullptr, &length) == ESP_OK) {
+                SettingsValue value;
+                value.str_value.resize(length);
+                ESP_ERROR_CHECK(nvs_get_str(handle, info.key, value.str_value.data(), &length));
+                while (!value.str_value.empty() && value.str_value.back() == '\0') {
+                    value.str_value.pop_back();
+                }
+                loaded.values[info.key] = std::move(value);
+            }
         }
-        nvs_close(nvs_handle_);
+        err = nvs_entry_next(&entry);
     }
+    nvs_release_iterator(entry);
+    nvs_close(handle);
+    ESP_LOGD(TAG, "Loaded %u keys from namespace %s", loaded.values.size(), ns.c_str());
+    return loaded;
 }
 
-std::string Settings::GetString(const std::string& key, const std::string& default_value) {
-    if (nvs_handle_ == 0) {
-        return default_value;
+void SettingsCache::MarkDirty(SettingsNamespace& ns) {
+    if (first_dirty_us_ == 0) {
+        first_dirty_us_ = esp_timer_get_time();
     }
+    ns.dirty = true;
+}
 
-    size_t length = 0;
-    if (nvs_get_str(nvs_handle_, key.c_str(), nullptr, &length) != ESP_OK) {
-        return default_value;
+void SettingsCache::ScheduleFlush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (first_dirty_us_ == 0) {
+        return;
+    }
+    // 每次修改都推迟提交，但从第一次修改算起不超过最大延迟
+    if (esp_timer_is_active(flush_timer_)) {
+        if (esp_timer_get_time() - first_dirty_us_ >= SETTINGS_FLUSH_MAX_DELAY_MS * 1000LL) {
+            return;
+        }
+        esp_timer_stop(flush_timer_);
+    }
+    esp_timer_start_once(flush_timer_, SETTINGS_FLUSH_DELAY_MS * 1000);
+}
+
+void SettingsCache::Flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (first_dirty_us_ == 0) {
+        return;
+    }
+    esp_timer_stop(flush_timer_);
+
+    int written = 0;
+    for (auto& [name, ns] : namespaces_) {
+        if (!ns.dirty) {
+            continue;
+        }
+        nvs_handle_t handle = 0;
+        esp_err_t err = nvs_open(name.c_str(), NVS_READWRITE, &handle);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to open namespace %s: %s", name.c_str(), esp_err_to_name(err));
+            continue;
+        }
+        if (ns.erase_all) {
+            ESP_ERROR_CHECK(nvs_erase_all(handle));
+            ns.erase_all = false;
+        }
+        for (auto it = ns.values.begin(); it != ns.values.end();) {
+            auto& value = it->second;
+            if (!value.dirty) {
+                ++it;
+                continue;
+            }
+            if (value.erased) {
+                err = nvs_erase_key(handle, it->first.c_str());
+                if (err != ESP_ERR_NVS_NOT_FOUND) {
+                    ESP_ERROR_CHECK(err);
+                }
+                it = ns.values.erase(it);
+            } else {
+                if (value.is_int) {
+                    ESP_ERROR_CHECK(nvs_set_i32(handle, it->first.c_str(), value.int_value));
+                } else {
+                    ESP_ERROR_CHECK(nvs_set_str(handle, it->first.c_str(), value.str_value.c_str()));
+                }
+                value.dirty = false;
+                ++it;
+            }
+            written++;
+        }
+        ESP_ERROR_CHECK(nvs_commit(handle));
+        nvs_close(handle);
+        ns.dirty = false;
+    }
+    ESP_LOGI(TAG, "Flushed %d keys, %d ms after the first change", written,
+        (int)((esp_timer_get_time() - first_dirty_us_) / 1000));
+    first_dirty_us_ = 0;
+}
+
+void SettingsCache::Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    esp_timer_stop(flush_timer_);
+    namespaces_.clear();
+    first_dirty_us_ = 0;
+}
+
+Settings::Settings(const std::string& ns, bool read_write) : ns_(ns), read_write_(read_write) {
+}
+
+Settings::~Settings() {
+    if (read_write_ && dirty_) {
+        SettingsCache::GetInstance().ScheduleFlush();
     }
+}
 
-    std::string value;
-    value.resize(length);
-    ESP_ERROR_CHECK(nvs_get_str(nvs_handle_, key.c_str(), value.data(), &length));
-    while (!value.empty() && value.back() == '\0') {
-        value.pop_back();
+void Settings::Flush() {
+    SettingsCache::GetInstance().Flush();
+}
+
+void Settings::ClearCache() {
+    SettingsCache::GetInstance().Clear();
+}
+
+std::string Settings::GetString(const std::string& key, const std::string& default_value) {
+    auto& cache = SettingsCache::GetInstance();
+    std::lock_guard<std::mutex> lock(cache.mutex_);
+    auto& ns = cache.Load(ns_);
+    auto it = ns.values.find(key);
+    if (it == ns.values.end() || it->second.erased || it->second.is_int) {
+        return default_value;
     }
-    return value;
+    return it->second.str_value;
 }
 
 void Settings::SetString(const std::string& key, const std::string& value) {
     if (read_write_) {
-        ESP_ERROR_CHECK(nvs_set_str(nvs_handle_, key.c_str(), value.c_str()));
+        auto& cache = SettingsCache::GetInstance();
+        std::lock_guard<std::mutex> lock(cache.mutex_);
+        auto& ns = cache.Load(ns_);
+        auto it = ns.values.find(key);
+        if (it != ns.values.end() && !it->second.erased && !it->second.is_int && it->second.str_value == value) {
+            return;
+        }
+        auto& item = ns.values[key];
+        item.is_int = false;
+        item.str_value = value;
+        item.erased = false;
+        item.dirty = true;
+        cache.MarkDirty(ns);
         dirty_ = true;
     } else {
         ESP_LOGW(TAG, "Namespace %s is not open for writing", ns_.c_str());
@@ -47,20 +254,32 @@ void Settings::SetString(const std::string& key, const std::string& value) {
 }
 
 int32_t Settings::GetInt(const std::string& key, int32_t default_value) {
-    if (nvs_handle_ == 0) {
+    auto& cache = SettingsCache::GetInstance();
+    std::lock_guard<std::mutex> lock(cache.mutex_);
+    auto& ns = cache.Load(ns_);
+    auto it = ns.values.find(key);
+    if (it == ns.values.end() || it->second.erased || !it->second.is_int) {
         return default_value;
     }
-
-    int32_t value;
-    if (nvs_get_i32(nvs_handle_, key.c_str(), &value) != ESP_OK) {
-        return default_value;
-    }
-    return value;
+    return it->second.int_value;
 }
 
 void Settings::SetInt(const std::string& key, int32_t value) {
     if (read_write_) {
-        ESP_ERROR_CHECK(nvs_set_i32(nvs_handle_, key.c_str(), value));
+        auto& cache = SettingsCache::GetInstance();
+        std::lock_guard<std::mutex> lock(cache.mutex_);
+        auto& ns = cache.Load(ns_);
+        // 值没有变化时不写入 flash
+        auto it = ns.values.find(key);
+        if (it != ns.values.end() && !it->second.erased && it->second.is_int && it->second.int_value == value) {
+            return;
+        }
+        auto& item = ns.values[key];
+        item.is_int = true;
+        item.int_value = value;
+        item.erased = false;
+        item.dirty = true;
+        cache.MarkDirty(ns);
         dirty_ = true;
     } else {
         ESP_LOGW(TAG, "Namespace %s is not open for writing", ns_.c_str());
@@ -69,10 +288,14 @@ void Settings::SetInt(const std::string& key, int32_t value) {
 
 void Settings::EraseKey(const std::string& key) {
     if (read_write_) {
-        auto ret = nvs_erase_key(nvs_handle_, key.c_str());
-        if (ret != ESP_ERR_NVS_NOT_FOUND) {
-            ESP_ERROR_CHECK(ret);
-        }
+        auto& cache = SettingsCache::GetInstance();
+        std::lock_guard<std::mutex> lock(cache.mutex_);
+        auto& ns = cache.Load(ns_);
+        auto& item = ns.values[key];
+        item.erased = true;
+        item.dirty = true;
+        cache.MarkDirty(ns);
+        dirty_ = true;
     } else {
         ESP_LOGW(TAG, "Namespace %s is not open for writing", ns_.c_str());
     }
@@ -80,7 +303,13 @@ void Settings::EraseKey(const std::string& key) {
 
 void Settings::EraseAll() {
     if (read_write_) {
-        ESP_ERROR_CHECK(nvs_erase_all(nvs_handle_));
+        auto& cache = SettingsCache::GetInstance();
+        std::lock_guard<std::mutex> lock(cache.mutex_);
+        auto& ns = cache.Load(ns_);
+        ns.values.clear();
+        ns.erase_all = true;
+        cache.MarkDirty(ns);
+        dirty_ = true;
     } else {
         ESP_LOGW(TAG, "Namespace %s is not open for writing", ns_.c_str());
     }
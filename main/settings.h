@@ -4,6 +4,13 @@
 #include <string>
 #include <nvs_flash.h>
 
+// 修改后延迟写入 NVS，连续修改（例如旋钮调节音量）只提交一次
+#define SETTINGS_FLUSH_DELAY_MS 3000
+// 持续修改时最多延迟这么久也要写入一次
+#define SETTINGS_FLUSH_MAX_DELAY_MS 10000
+
+// 所有 Settings 对象共享一份按命名空间加载的缓存，读取不访问 flash，
+// 修改在对象析构后延迟批量提交，esp_restart 前会自动提交，深度睡眠和断电前需要调用 Flush
 class Settings {
 public:
     Settings(const std::string& ns, bool read_write = false);
@@ -16,9 +23,13 @@ public:
     void EraseKey(const std::string& key);
     void EraseAll();
 
+    // 立即把所有未提交的修改写入 NVS
+    static void Flush();
+    // NVS 被擦除后丢弃缓存和未提交的修改，之后重新从 NVS 读取
+    static void ClearCache();
+
 private:
     std::string ns_;
-    nvs_handle_t nvs_handle_ = 0;
     bool read_write_ = false;
     bool dirty_ = false;
 };
@@ -1,4 +1,5 @@
 #include "system_info.h"
+#include "heap_tag.h"
 
 #include <freertos/task.h>
 #include <esp_log.h>
@@ -143,3 +144,18 @@ void SystemInfo::PrintHeapStats() {
     int min_free_sram = heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL);
     ESP_LOGI(TAG, "free sram: %u minimal sram: %u", free_sram, min_free_sram);
 }
+
+void SystemInfo::PrintHeapTagStats() {
+#if CONFIG_USE_HEAP_TAGGING
+    for (int i = kHeapTagNone + 1; i < kHeapTagCount; i++) {
+        auto tag = (HeapTag)i;
+        auto stats = HeapTagger::GetStats(tag);
+        ESP_LOGI(TAG, "heap %-16s live: %u bytes in %lu blocks, peak: %u, allocations: %lu",
+            HeapTagger::GetName(tag), stats.live_bytes, stats.live_count, stats.peak_bytes, stats.alloc_count);
+    }
+    auto untracked = HeapTagger::GetUntrackedCount();
+    if (untracked > 0) {
+        ESP_LOGW(TAG, "heap tagging table is full, %lu allocations untracked", untracked);
+    }
+#endif
+}
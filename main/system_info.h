@@ -16,6 +16,8 @@ public:
     static esp_err_t PrintTaskCpuUsage(TickType_t xTicksToWait);
     static void PrintTaskList();
     static void PrintHeapStats();
+    // 按子系统打印内部 RAM 的占用，需要开启 CONFIG_USE_HEAP_TAGGING
+    static void PrintHeapTagStats();
 };
 
 #endif // _SYSTEM_INFO_H_
@@ -0,0 +1,300 @@
+#include "telemetry.h"
+#include "heap_tag.h"
+
+#include <esp_log.h>
+#include <esp_heap_caps.h>
+#include <esp_console.h>
+#include <mbedtls/base64.h>
+#include <cJSON.h>
+
+#include <cstring>
+#include <algorithm>
+
+#define TAG "Telemetry"
+
+Telemetry::Telemetry() {
+    capacity_ = CONFIG_TELEMETRY_HISTORY_MINUTES * 60 / CONFIG_TELEMETRY_INTERVAL_SECONDS;
+    samples_ = (TelemetrySample*)heap_caps_malloc(capacity_ * sizeof(TelemetrySample), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (samples_ == nullptr) {
+        samples_ = (TelemetrySample*)heap_caps_malloc(capacity_ * sizeof(TelemetrySample), MALLOC_CAP_8BIT);
+    }
+    if (samples_ == nullptr) {
+        ESP_LOGE(TAG, "Failed to allocate %u samples", capacity_);
+        capacity_ = 0;
+    }
+}
+
+Telemetry::~Telemetry() {
+    if (timer_ != nullptr) {
+        esp_timer_stop(timer_);
+        esp_timer_delete(timer_);
+    }
+    heap_caps_free(samples_);
+}
+
+void Telemetry::Start() {
+    if (timer_ != nullptr || capacity_ == 0) {
+        return;
+    }
+    esp_timer_create_args_t timer_args = {
+        .callback = [](void* arg) {
+            static_cast<Telemetry*>(arg)->Sample();
+        },
+        .arg = this,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "telemetry",
+        .skip_unhandled_events = true
+    };
+    esp_timer_create(&timer_args, &timer_);
+    esp_timer_start_periodic(timer_, CONFIG_TELEMETRY_INTERVAL_SECONDS * 1000000LL);
+    RegisterConsoleCommand();
+    ESP_LOGI(TAG, "Recording %u samples every %d seconds, %u bytes", capacity_, CONFIG_TELEMETRY_INTERVAL_SECONDS,
+        capacity_ * sizeof(TelemetrySample));
+}
+
+// 与上一次采样的运行时间相减得到 CPU 占用，不需要像 PrintTaskCpuUsage 那样等待
+void Telemetry::Sample() {
+    UBaseType_t task_count = uxTaskGetNumberOfTasks() + 4;
+    if (task_status_.size() < task_count) {
+        task_status_.resize(task_count);
+    }
+    configRUN_TIME_COUNTER_TYPE total_run_time = 0;
+    task_count = uxTaskGetSystemState(task_status_.data(), task_status_.size(), &total_run_time);
+    if (task_count == 0) {
+        return;
+    }
+
+    TelemetrySample sample = {};
+    sample.uptime_s = esp_timer_get_time() / 1000000;
+    sample.free_internal = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    sample.largest_internal = heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL);
+    sample.min_free_internal = heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL);
+    sample.free_psram = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+
+    uint64_t elapsed = (uint64_t)(total_run_time - last_total_run_time_) * CONFIG_FREERTOS_NUMBER_OF_CORES;
+    std::vector<std::pair<TaskHandle_t, configRUN_TIME_COUNTER_TYPE>> run_time;
+    run_time.reserve(task_count);
+    std::vector<std::pair<uint8_t, UBaseType_t>> usage;
+    usage.reserve(task_count);
+    for (UBaseType_t i = 0; i < task_count; i++) {
+        auto& status = task_status_[i];
+        run_time.emplace_back(status.xHandle, status.ulRunTimeCounter);
+        uint8_t cpu_percent = 0;
+        if (last_total_run_time_ != 0 && elapsed > 0) {
+            auto last = std::find_if(last_run_time_.begin(), last_run_time_.end(), [&status](const auto& item) {
+                return item.first == status.xHandle;
+            });
+            if (last != last_run_time_.end()) {
+                cpu_percent = std::min<uint64_t>((uint64_t)(status.ulRunTimeCounter - last->second) * 100 / elapsed, 100);
+            }
+        }
+        usage.emplace_back(cpu_percent, i);
+    }
+    last_run_time_ = std::move(run_time);
+    last_total_run_time_ = total_run_time;
+
+    // 任务较多时只保留 CPU 占用最高的几个
+    std::stable_sort(usage.begin(), usage.end(), [](const auto& a, const auto& b) {
+        return a.first > b.first;
+    });
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& [cpu_percent, i] : usage) {
+        if (sample.task_count >= TELEMETRY_MAX_TASKS) {
+            break;
+        }
+        uint8_t name_index = GetNameIndex(task_status_[i].pcTaskName);
+        if (name_index == UINT8_MAX) {
+            continue;
+        }
+        auto& task = sample.tasks[sample.task_count++];
+        task.name_index = name_index;
+        task.cpu_percent = cpu_percent;
+        task.stack_free = std::min<uint32_t>(task_status_[i].usStackHighWaterMark, UINT16_MAX);
+    }
+    samples_[head_] = sample;
+    head_ = (head_ + 1) % capacity_;
+    count_ = std::min(count_ + 1, capacity_);
+}
+
+uint8_t Telemetry::GetNameIndex(const char* name) {
+    for (size_t i = 0; i < name_count_; i++) {
+        if (strncmp(names_[i], name, TELEMETRY_TASK_NAME_SIZE) == 0) {
+            return i;
+        }
+    }
+    if (name_count_ >= TELEMETRY_MAX_TASK_NAMES) {
+        return UINT8_MAX;
+    }
+    strncpy(names_[name_count_], name, TELEMETRY_TASK_NAME_SIZE - 1);
+    return name_count_++;
+}
+
+size_t Telemetry::GetRecentCount(int minutes) {
+    if (count_ == 0) {
+        return 0;
+    }
+    uint32_t newest = GetRecent(count_, count_ - 1).uptime_s;
+    size_t count = 0;
+    while (count < count_ && newest - GetRecent(count_, count_ - 1 - count).uptime_s < (uint32_t)minutes * 60) {
+        count++;
+    }
+    return count;
+}
+
+const TelemetrySample& Telemetry::GetRecent(size_t count, size_t i) {
+    return samples_[(head_ + capacity_ - count + i) % capacity_];
+}
+
+std::vector<TelemetryTaskSummary> Telemetry::Summarize(size_t count) {
+    std::vector<TelemetryTaskSummary> summary(name_count_);
+    for (size_t i = 0; i < count; i++) {
+        auto& sample = GetRecent(count, i);
+        for (size_t j = 0; j < sample.task_count; j++) {
+            auto& task = sample.tasks[j];
+            auto& item = summary[task.name_index];
+            item.cpu_sum += task.cpu_percent;
+            item.sample_count++;
+            item.max_cpu = std::max(item.max_cpu, task.cpu_percent);
+            item.min_stack_free = std::min(item.min_stack_free, task.stack_free);
+        }
+    }
+    return summary;
+}
+
+std::string Telemetry::GetJson(int minutes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = GetRecentCount(minutes);
+
+    cJSON* root = cJSON_CreateObject();
+    cJSON_AddNumberToObject(root, "interval", CONFIG_TELEMETRY_INTERVAL_SECONDS);
+    cJSON* heap = cJSON_CreateArray();
+    for (size_t i = 0; i < count; i++) {
+        auto& sample = GetRecent(count, i);
+        cJSON* item = cJSON_CreateArray();
+        cJSON_AddItemToArray(item, cJSON_CreateNumber(sample.uptime_s));
+        cJSON_AddItemToArray(item, cJSON_CreateNumber(sample.free_internal));
+        cJSON_AddItemToArray(item, cJSON_CreateNumber(sample.largest_internal));
+        cJSON_AddItemToArray(item, cJSON_CreateNumber(sample.min_free_internal));
+        cJSON_AddItemToArray(item, cJSON_CreateNumber(sample.free_psram));
+        cJSON_AddItemToArray(heap, item);
+    }
+    cJSON_AddItemToObject(root, "heap_fields", cJSON_CreateString("uptime,free_internal,largest_internal,min_free_internal,free_psram"));
+    cJSON_AddItemToObject(root, "heap", heap);
+
+    cJSON* tasks = cJSON_CreateArray();
+    auto summary = Summarize(count);
+    for (size_t i = 0; i < summary.size(); i++) {
+        auto& item = summary[i];
+        if (item.sample_count == 0) {
+            continue;
+        }
+        cJSON* task = cJSON_CreateObject();
+        cJSON_AddStringToObject(task, "name", names_[i]);
+        cJSON_AddNumberToObject(task, "avg_cpu", item.cpu_sum / item.sample_count);
+        cJSON_AddNumberToObject(task, "max_cpu", item.max_cpu);
+        cJSON_AddNumberToObject(task, "min_stack_free", item.min_stack_free);
+        cJSON_AddItemToArray(tasks, task);
+    }
+    cJSON_AddItemToObject(root, "tasks", tasks);
+
+#if CONFIG_USE_HEAP_TAGGING
+    cJSON* heap_tags = cJSON_CreateArray();
+    for (int i = kHeapTagNone + 1; i < kHeapTagCount; i++) {
+        auto stats = HeapTagger::GetStats((HeapTag)i);
+        cJSON* item = cJSON_CreateObject();
+        cJSON_AddStringToObject(item, "name", HeapTagger::GetName((HeapTag)i));
+        cJSON_AddNumberToObject(item, "live_bytes", stats.live_bytes);
+        cJSON_AddNumberToObject(item, "peak_bytes", stats.peak_bytes);
+        cJSON_AddNumberToObject(item, "live_count", stats.live_count);
+        cJSON_AddNumberToObject(item, "alloc_count", stats.alloc_count);
+        cJSON_AddItemToArray(heap_tags, item);
+    }
+    cJSON_AddItemToObject(root, "heap_tags", heap_tags);
+#endif
+
+    auto json_str = cJSON_PrintUnformatted(root);
+    std::string json(json_str);
+    cJSON_free(json_str);
+    cJSON_Delete(root);
+    return json;
+}
+
+void Telemetry::PrintHistory(int minutes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = GetRecentCount(minutes);
+    printf("| Uptime | Free SRAM | Largest | Min SRAM | Free PSRAM\n");
+    for (size_t i = 0; i < count; i++) {
+        auto& sample = GetRecent(count, i);
+        printf("| %6lu | %9lu | %7lu | %8lu | %10lu\n", sample.uptime_s, sample.free_internal,
+            sample.largest_internal, sample.min_free_internal, sample.free_psram);
+    }
+    printf("| Task | Avg CPU | Max CPU | Min Stack Free\n");
+    auto summary = Summarize(count);
+    for (size_t i = 0; i < summary.size(); i++) {
+        auto& item = summary[i];
+        if (item.sample_count > 0) {
+            printf("| %-16s | %6lu%% | %6u%% | %6u\n", names_[i], item.cpu_sum / item.sample_count,
+                item.max_cpu, item.min_stack_free);
+        }
+    }
+}
+
+std::vector<uint8_t> Telemetry::Export(int minutes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = GetRecentCount(minutes);
+
+    TelemetryExportHeader header = {};
+    memcpy(header.magic, TELEMETRY_EXPORT_MAGIC, sizeof(header.magic));
+    header.version = TELEMETRY_EXPORT_VERSION;
+    header.interval_s = CONFIG_TELEMETRY_INTERVAL_SECONDS;
+    header.name_count = name_count_;
+    header.sample_count = count;
+    header.sample_size = sizeof(TelemetrySample);
+    header.max_tasks = TELEMETRY_MAX_TASKS;
+
+    std::vector<uint8_t> data(sizeof(header) + name_count_ * TELEMETRY_TASK_NAME_SIZE + count * sizeof(TelemetrySample));
+    auto p = data.data();
+    memcpy(p, &header, sizeof(header));
+    p += sizeof(header);
+    memcpy(p, names_, name_count_ * TELEMETRY_TASK_NAME_SIZE);
+    p += name_count_ * TELEMETRY_TASK_NAME_SIZE;
+    for (size_t i = 0; i < count; i++) {
+        memcpy(p, &GetRecent(count, i), sizeof(TelemetrySample));
+        p += sizeof(TelemetrySample);
+    }
+    return data;
+}
+
+// 在启用了串口控制台的板子上可以使用 telemetry 命令
+void Telemetry::RegisterConsoleCommand() {
+    const esp_console_cmd_t cmd = {
+        .command = "telemetry",
+        .help = "Print heap and task usage of the last N minutes, or export them in base64: telemetry [minutes] [export]",
+        .hint = nullptr,
+        .func = [](int argc, char** argv) -> int {
+            int minutes = argc > 1 ? atoi(argv[1]) : 5;
+            if (minutes <= 0) {
+                minutes = CONFIG_TELEMETRY_HISTORY_MINUTES;
+            }
+            auto& telemetry = Telemetry::GetInstance();
+            if (argc > 2 && strcmp(argv[2], "export") == 0) {
+                auto data = telemetry.Export(minutes);
+                size_t length = 0;
+                mbedtls_base64_encode(nullptr, 0, &length, data.data(), data.size());
+                std::string base64(length, '\0');
+                mbedtls_base64_encode((unsigned char*)base64.data(), length, &length, data.data(), data.size());
+                base64.resize(length);
+                printf("%s\n", base64.c_str());
+            } else {
+                telemetry.PrintHistory(minutes);
+            }
+            return 0;
+        },
+        .argtable = nullptr
+    };
+    esp_err_t err = esp_console_cmd_register(&cmd);
+    if (err != ESP_OK) {
+        ESP_LOGD(TAG, "Console command not registered: %s", esp_err_to_name(err));
+    }
+}
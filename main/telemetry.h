@@ -0,0 +1,101 @@
+#ifndef _TELEMETRY_H_
+#define _TELEMETRY_H_
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <cstdint>
+
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// 每个样本最多记录的任务数，按 CPU 占用从高到低保留
+#define TELEMETRY_MAX_TASKS 16
+// 任务名表的容量，样本中只保存任务名的序号
+#define TELEMETRY_MAX_TASK_NAMES 48
+#define TELEMETRY_TASK_NAME_SIZE 16
+// 导出的二进制格式，由 scripts/decode_telemetry.py 解析，所有字段均为小端
+#define TELEMETRY_EXPORT_MAGIC "XZTM"
+#define TELEMETRY_EXPORT_VERSION 1
+
+struct TelemetryTask {
+    uint8_t name_index;         // 任务名表中的序号
+    uint8_t cpu_percent;        // 两次采样之间占用所有核心的百分比
+    uint16_t stack_free;        // 栈剩余空间的历史最小值（字节）
+};
+
+struct TelemetrySample {
+    uint32_t uptime_s;
+    uint32_t free_internal;
+    uint32_t largest_internal;  // 内部 RAM 最大的空闲块
+    uint32_t min_free_internal;
+    uint32_t free_psram;
+    uint8_t task_count;
+    uint8_t reserved[3];
+    TelemetryTask tasks[TELEMETRY_MAX_TASKS];
+};
+
+// 一段时间内某个任务的汇总
+struct TelemetryTaskSummary {
+    uint32_t cpu_sum = 0;
+    uint32_t sample_count = 0;
+    uint8_t max_cpu = 0;
+    uint16_t min_stack_free = UINT16_MAX;
+};
+
+struct TelemetryExportHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t interval_s;
+    uint16_t name_count;
+    uint16_t sample_count;
+    uint16_t sample_size;
+    uint16_t max_tasks;
+};
+
+// 定时记录堆内存和各任务的 CPU、栈使用情况到固定大小的环形缓冲区，采样不会阻塞调用者
+class Telemetry {
+public:
+    static Telemetry& GetInstance() {
+        static Telemetry instance;
+        return instance;
+    }
+    Telemetry(const Telemetry&) = delete;
+    Telemetry& operator=(const Telemetry&) = delete;
+
+    void Start();
+    // 最近若干分钟的堆内存曲线，以及每个任务的平均、最高 CPU 占用和最小栈剩余
+    std::string GetJson(int minutes);
+    void PrintHistory(int minutes);
+    // 文件头、任务名表和样本依次排列的二进制数据
+    std::vector<uint8_t> Export(int minutes);
+
+private:
+    Telemetry();
+    ~Telemetry();
+
+    std::mutex mutex_;
+    esp_timer_handle_t timer_ = nullptr;
+    TelemetrySample* samples_ = nullptr;
+    size_t capacity_ = 0;
+    size_t count_ = 0;
+    size_t head_ = 0;           // 下一个样本写入的位置
+    char names_[TELEMETRY_MAX_TASK_NAMES][TELEMETRY_TASK_NAME_SIZE] = {};
+    size_t name_count_ = 0;
+
+    // 上一次采样时各任务的运行时间，用于计算 CPU 占用
+    std::vector<TaskStatus_t> task_status_;
+    std::vector<std::pair<TaskHandle_t, configRUN_TIME_COUNTER_TYPE>> last_run_time_;
+    configRUN_TIME_COUNTER_TYPE last_total_run_time_ = 0;
+
+    void Sample();
+    uint8_t GetNameIndex(const char* name);
+    // 调用前需持有 mutex_，返回最近 minutes 分钟内样本的数量
+    size_t GetRecentCount(int minutes);
+    const TelemetrySample& GetRecent(size_t count, size_t i);
+    std::vector<TelemetryTaskSummary> Summarize(size_t count);
+    void RegisterConsoleCommand();
+};
+
+#endif // _TELEMETRY_H_
@@ -0,0 +1,38 @@
+#!/usr/bin/env python3
+# 压缩固件用于 OTA，格式与 main/ota_decompressor.h 保持一致
+# 设备端的解压窗口为 2^window_bits 字节，不能超过 CONFIG_OTA_DECOMPRESS_MAX_WINDOW_BITS
+import argparse
+import struct
+import zlib
+
+COMPRESSED_MAGIC = b"XZDEFL01"
+HEADER_FORMAT = "<8sII"
+
+
+def compress_firmware(data, window_bits):
+    # 负的 wbits 表示不带 zlib 头的 raw deflate，匹配距离不超过窗口大小
+    compressor = zlib.compressobj(9, zlib.DEFLATED, -window_bits, 9)
+    compressed = compressor.compress(data) + compressor.flush()
+    return struct.pack(HEADER_FORMAT, COMPRESSED_MAGIC, window_bits, len(data)) + compressed
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--input", required=True, help="固件或补丁文件")
+    parser.add_argument("--output", required=True, help="输出文件路径")
+    parser.add_argument("--window-bits", type=int, default=12, choices=range(9, 16), metavar="[9-15]",
+                        help="解压窗口大小为 2^N 字节，默认 12")
+    args = parser.parse_args()
+
+    with open(args.input, "rb") as f:
+        data = f.read()
+    compressed = compress_firmware(data, args.window_bits)
+
+    # 验证解压结果
+    decompressor = zlib.decompressobj(-args.window_bits)
+    if decompressor.decompress(compressed[struct.calcsize(HEADER_FORMAT):]) != data:
+        raise RuntimeError("Verification failed")
+    with open(args.output, "wb") as f:
+        f.write(compressed)
+    print(f"Compressed {len(data)} -> {len(compressed)} bytes ({len(compressed) * 100 // len(data)}%), "
+          f"window {1 << args.window_bits} bytes")
@@ -0,0 +1,49 @@
+#!/usr/bin/env python3
+# 解析串口控制台 `telemetry <minutes> export` 输出的 base64 数据，格式与 main/telemetry.h 保持一致
+import argparse
+import base64
+import struct
+import sys
+
+EXPORT_MAGIC = b"XZTM"
+HEADER_FORMAT = "<4sHHHHHH"
+SAMPLE_FORMAT = "<IIIIIB3x"
+TASK_FORMAT = "<BBH"
+TASK_NAME_SIZE = 16
+
+
+def decode(data):
+    magic, version, interval, name_count, sample_count, sample_size, max_tasks = struct.unpack_from(HEADER_FORMAT, data)
+    if magic != EXPORT_MAGIC or version != 1:
+        raise ValueError("Not a telemetry export")
+    offset = struct.calcsize(HEADER_FORMAT)
+    names = []
+    for _ in range(name_count):
+        names.append(data[offset:offset + TASK_NAME_SIZE].split(b"\0")[0].decode(errors="replace"))
+        offset += TASK_NAME_SIZE
+
+    samples = []
+    for _ in range(sample_count):
+        uptime, free_internal, largest, min_free, free_psram, task_count = struct.unpack_from(SAMPLE_FORMAT, data, offset)
+        tasks = []
+        task_offset = offset + struct.calcsize(SAMPLE_FORMAT)
+        for i in range(min(task_count, max_tasks)):
+            name_index, cpu, stack_free = struct.unpack_from(TASK_FORMAT, data, task_offset + i * struct.calcsize(TASK_FORMAT))
+            tasks.append((names[name_index], cpu, stack_free))
+        samples.append((uptime, free_internal, largest, min_free, free_psram, tasks))
+        offset += sample_size
+    return interval, samples
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("input", nargs="?", help="保存了 base64 输出的文件，默认从标准输入读取")
+    args = parser.parse_args()
+
+    text = open(args.input).read() if args.input else sys.stdin.read()
+    interval, samples = decode(base64.b64decode("".join(text.split())))
+    print(f"{len(samples)} samples, every {interval} seconds")
+    print("uptime  free_sram  largest  min_sram  free_psram  top tasks (cpu%, stack free)")
+    for uptime, free_internal, largest, min_free, free_psram, tasks in samples:
+        top = ", ".join(f"{name} {cpu}% {stack}" for name, cpu, stack in tasks[:3])
+        print(f"{uptime:6d}  {free_internal:9d}  {largest:7d}  {min_free:8d}  {free_psram:10d}  {top}")
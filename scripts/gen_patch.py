@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+# 生成差分升级补丁，格式与 main/ota_patch.h 保持一致
+# 需要安装 bsdiff4: pip install bsdiff4
+import argparse
+import hashlib
+import struct
+
+import bsdiff4.core
+
+PATCH_MAGIC = b"XZPATCH1"
+HEADER_FORMAT = "<8sII32s"
+CONTROL_FORMAT = "<IIi"
+
+
+def image_sha256(image):
+    # 设备端通过 esp_partition_get_sha256 读取镜像末尾附加的 SHA-256
+    sha256 = image[-32:]
+    if hashlib.sha256(image[:-32]).digest() != sha256:
+        raise ValueError("Base image has no appended SHA-256, was it built with CONFIG_APP_BUILD_TYPE_APP_2NDBOOT?")
+    return sha256
+
+
+def generate_patch(base, target):
+    control, diff_data, extra_data = bsdiff4.core.diff(base, target)
+
+    # 把 diff 和 extra 数据紧跟在各自的控制块后面，设备端可以边下载边还原
+    patch = bytearray(struct.pack(HEADER_FORMAT, PATCH_MAGIC, len(base), len(target), image_sha256(base)))
+    diff_offset = 0
+    extra_offset = 0
+    for diff_size, extra_size, seek in control:
+        patch += struct.pack(CONTROL_FORMAT, diff_size, extra_size, seek)
+        patch += diff_data[diff_offset:diff_offset + diff_size]
+        patch += extra_data[extra_offset:extra_offset + extra_size]
+        diff_offset += diff_size
+        extra_offset += extra_size
+    return bytes(patch)
+
+
+def apply_patch(base, patch):
+    magic, base_size, target_size, sha256 = struct.unpack_from(HEADER_FORMAT, patch)
+    if magic != PATCH_MAGIC or base_size != len(base) or sha256 != image_sha256(base):
+        raise ValueError("Patch does not match the base image")
+    offset = struct.calcsize(HEADER_FORMAT)
+    base_offset = 0
+    target = bytearray()
+    while offset < len(patch):
+        diff_size, extra_size, seek = struct.unpack_from(CONTROL_FORMAT, patch, offset)
+        offset += struct.calcsize(CONTROL_FORMAT)
+        for i in range(diff_size):
+            target.append((base[base_offset + i] + patch[offset + i]) & 0xFF)
+        offset += diff_size
+        base_offset += diff_size
+        target += patch[offset:offset + extra_size]
+        offset += extra_size
+        base_offset += seek
+    if len(target) != target_size:
+        raise ValueError("Patch is incomplete")
+    return bytes(target)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--base", required=True, help="设备上当前运行的固件 (build/xiaozhi.bin)")
+    parser.add_argument("--target", required=True, help="新固件")
+    parser.add_argument("--output", required=True, help="输出补丁文件路径")
+    args = parser.parse_args()
+
+    with open(args.base, "rb") as f:
+        base = f.read()
+    with open(args.target, "rb") as f:
+        target = f.read()
+
+    patch = generate_patch(base, target)
+    if apply_patch(base, patch) != target:
+        raise RuntimeError("Patch verification failed")
+    with open(args.output, "wb") as f:
+        f.write(patch)
+    print(f"Patch {len(patch)} bytes, {len(patch) * 100 // len(target)}% of the full firmware")
@@ -0,0 +1,58 @@
+#!/usr/bin/env python3
+# 把音效等资源打包成 assets 分区镜像，格式与 main/assets.h 保持一致
+import argparse
+import os
+import struct
+import zlib
+
+ASSETS_MAGIC = 0x53415a58  # "XZAS"
+ASSETS_FORMAT_VERSION = 1
+HEADER_FORMAT = "<II32sIIII"
+ENTRY_FORMAT = "<III20s"
+ALIGNMENT = 4
+
+
+def fnv1a(name):
+    value = 0x811c9dc5
+    for byte in name.encode("utf-8"):
+        value = ((value ^ byte) * 0x01000193) & 0xFFFFFFFF
+    return value
+
+
+def pack_assets(files, output_path, version):
+    entries = {}
+    for path in files:
+        name = os.path.basename(path)
+        if len(name.encode("utf-8")) > 20:
+            raise ValueError(f"Asset name too long: {name}")
+        asset_id = fnv1a(name)
+        if asset_id in entries:
+            raise ValueError(f"Duplicate asset: {name} ({entries[asset_id][0]})")
+        with open(path, "rb") as f:
+            entries[asset_id] = (name, f.read())
+
+    index = b""
+    data = b""
+    for asset_id in sorted(entries):
+        name, content = entries[asset_id]
+        index += struct.pack(ENTRY_FORMAT, asset_id, len(data), len(content), name.encode("utf-8"))
+        data += content
+        data += b"\0" * (-len(data) % ALIGNMENT)
+
+    header = struct.pack(HEADER_FORMAT, ASSETS_MAGIC, ASSETS_FORMAT_VERSION, version.encode("utf-8")[:31],
+                         len(entries), len(data), zlib.crc32(data), 0)
+
+    os.makedirs(os.path.dirname(os.path.abspath(output_path)), exist_ok=True)
+    with open(output_path, "wb") as f:
+        f.write(header + index + data)
+    print(f"Packed {len(entries)} assets ({len(header) + len(index) + len(data)} bytes) into {output_path}")
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--output", required=True, help="输出镜像文件路径")
+    parser.add_argument("--version", default="1", help="资源版本")
+    parser.add_argument("files", nargs="+", help="要打包的资源文件")
+    args = parser.parse_args()
+
+    pack_assets(args.files, args.output, args.version)